@@ -36,13 +36,47 @@ enum AdcReference : byte {
     ReferenceInternal,
 };
 
+/**
+ * Adc clock prescaler
+ * Full accuracy requires an Adc clock
+ * between 50kHz and 200kHz (128 at 16MHz).
+ * Faster clocks trade resolution for speed.
+ */
+enum AdcPrescaler : byte {
+    PrescalerDiv2,
+    PrescalerDiv4,
+    PrescalerDiv8,
+    PrescalerDiv16,
+    PrescalerDiv32,
+    PrescalerDiv64,
+    PrescalerDiv128,
+};
+
+/**
+ * Adc conversion trigger source
+ * Single : conversion is started manually
+ * FreeRunning : a new conversion is started
+ * as soon as the previous one is completed
+ * Other sources start a conversion on the
+ * associated peripheral interrupt flag
+ */
+enum AdcTrigger : byte {
+    TriggerSingle,
+    TriggerFreeRunning,
+    TriggerComparator,
+    TriggerInt0,
+    TriggerTimer0MatchA,
+    TriggerTimer0Overflow,
+    TriggerTimer1MatchB,
+    TriggerTimer1Overflow,
+    TriggerTimer1Capture,
+};
+
 /**
  * Analog to Digital Converter
  * 
  * Current implementation is limited.
- * Only 128 prescaler is supported (full accuraty).
  * Only 6 input pins are supported.
- * Only single mode is supported.
  */
 struct AdcObject
 {
@@ -135,6 +169,75 @@ struct AdcObject
             bits::Bit7, bits::Bit2, bits::Bit1, bits::Bit0);
     }
 
+    /**
+     * Set Adc clock prescaler
+     * (enable() resets the prescaler to 128)
+     */
+    inline void setPrescaler(AdcPrescaler prescaler) const
+    {
+        if (prescaler == PrescalerDiv2) {
+            bits::add(*controlStatusAReg, 
+                ~bits::Bit4, ~bits::Bit2, ~bits::Bit1, bits::Bit0);
+        } else if (prescaler == PrescalerDiv4) {
+            bits::add(*controlStatusAReg, 
+                ~bits::Bit4, ~bits::Bit2, bits::Bit1, ~bits::Bit0);
+        } else if (prescaler == PrescalerDiv8) {
+            bits::add(*controlStatusAReg, 
+                ~bits::Bit4, ~bits::Bit2, bits::Bit1, bits::Bit0);
+        } else if (prescaler == PrescalerDiv16) {
+            bits::add(*controlStatusAReg, 
+                ~bits::Bit4, bits::Bit2, ~bits::Bit1, ~bits::Bit0);
+        } else if (prescaler == PrescalerDiv32) {
+            bits::add(*controlStatusAReg, 
+                ~bits::Bit4, bits::Bit2, ~bits::Bit1, bits::Bit0);
+        } else if (prescaler == PrescalerDiv64) {
+            bits::add(*controlStatusAReg, 
+                ~bits::Bit4, bits::Bit2, bits::Bit1, ~bits::Bit0);
+        } else if (prescaler == PrescalerDiv128) {
+            bits::add(*controlStatusAReg, 
+                ~bits::Bit4, bits::Bit2, bits::Bit1, bits::Bit0);
+        }
+    }
+
+    /**
+     * Set Adc conversion trigger source
+     * (In free running mode, startConversion()
+     * has to be called once)
+     */
+    inline void setTrigger(AdcTrigger trigger) const
+    {
+        if (trigger == TriggerSingle) {
+            bits::add(*controlStatusAReg, ~bits::Bit5, ~bits::Bit4);
+            return;
+        }
+        if (trigger == TriggerFreeRunning) {
+            bits::add(*controlStatusBReg, 
+                ~bits::Bit2, ~bits::Bit1, ~bits::Bit0);
+        } else if (trigger == TriggerComparator) {
+            bits::add(*controlStatusBReg, 
+                ~bits::Bit2, ~bits::Bit1, bits::Bit0);
+        } else if (trigger == TriggerInt0) {
+            bits::add(*controlStatusBReg, 
+                ~bits::Bit2, bits::Bit1, ~bits::Bit0);
+        } else if (trigger == TriggerTimer0MatchA) {
+            bits::add(*controlStatusBReg, 
+                ~bits::Bit2, bits::Bit1, bits::Bit0);
+        } else if (trigger == TriggerTimer0Overflow) {
+            bits::add(*controlStatusBReg, 
+                bits::Bit2, ~bits::Bit1, ~bits::Bit0);
+        } else if (trigger == TriggerTimer1MatchB) {
+            bits::add(*controlStatusBReg, 
+                bits::Bit2, ~bits::Bit1, bits::Bit0);
+        } else if (trigger == TriggerTimer1Overflow) {
+            bits::add(*controlStatusBReg, 
+                bits::Bit2, bits::Bit1, ~bits::Bit0);
+        } else if (trigger == TriggerTimer1Capture) {
+            bits::add(*controlStatusBReg, 
+                bits::Bit2, bits::Bit1, bits::Bit0);
+        }
+        bits::add(*controlStatusAReg, bits::Bit5, ~bits::Bit4);
+    }
+
     /**
      * Disable the Adc znd stop current conversion
      */
@@ -205,6 +308,7 @@ AdcObject Adc = {
  */
 ISR(ADC_vect)
 {
+    ISR_PROBE(isr::VectorAdc);
     if (Adc.onConversionCompleteFunc != AdcObject::Handler::Disable) {
         Adc.onConversionCompleteFunc(Adc);
     }
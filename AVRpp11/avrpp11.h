@@ -9,6 +9,7 @@
 #include "isr.h"
 #include "gpio.h"
 #include "adc.h"
+#include "comparator.h"
 #include "usart.h"
 #include "spi.h"
 #include "timer.h"
@@ -0,0 +1,258 @@
+#ifndef COMPARATOR_H
+#define COMPARATOR_H
+
+namespace comparator {
+
+/**
+ * Comparator positive input
+ * Either AIN0 pin or internal
+ * 1.1V bandgap reference
+ */
+enum ComparatorPositive : byte {
+    PositivePinAin0,
+    PositiveBandgap,
+};
+
+/**
+ * Comparator negative input
+ * Either AIN1 pin or one of the
+ * Adc multiplexer pins
+ * (The Adc has to be disabled
+ * to use the multiplexer)
+ */
+enum ComparatorNegative : byte {
+    NegativePinAin1,
+    NegativePinAdc0,
+    NegativePinAdc1,
+    NegativePinAdc2,
+    NegativePinAdc3,
+    NegativePinAdc4,
+    NegativePinAdc5,
+};
+
+/**
+ * Comparator output edge
+ * triggering the interrupt
+ * and the input capture
+ * Toggle : both rising and falling edge
+ * Falling : positive input goes below negative input
+ * Rising : positive input goes above negative input
+ */
+enum ComparatorEdge : byte {
+    EdgeToggle,
+    EdgeFalling,
+    EdgeRising,
+};
+
+/**
+ * Analog Comparator
+ *
+ * Compare positive and negative input
+ * voltage and set its output high when
+ * positive is greater than negative.
+ * The output can be routed to Timer1
+ * input capture unit for hardware timestamps.
+ */
+struct ComparatorObject
+{
+    /**
+     * Comparator specific interrupt handler
+     */
+    typedef isr::Handler<ComparatorObject> Handler;
+
+    /**
+     * Control and status, Adc control and status A/B,
+     * Adc multiplexer selection and
+     * digital input disable registers
+     */
+    const bytePtr controlStatusReg;
+    const bytePtr adcControlStatusAReg;
+    const bytePtr adcControlStatusBReg;
+    const bytePtr multiplexerReg;
+    const bytePtr inputDisableReg;
+
+    /**
+     * User defined
+     * interrupt routines
+     */
+    Handler::type onTriggerFunc;
+
+    /**
+     * Enable the comparator and disable
+     * AIN0 and AIN1 digital input buffers
+     */
+    inline void enable() const
+    {
+        bits::add(*inputDisableReg, bits::Bit1, bits::Bit0);
+        bits::add(*controlStatusReg, ~bits::Bit7, ~bits::Bit4);
+    }
+
+    /**
+     * Disable the comparator
+     * (power saving)
+     * The interrupt has to be disabled
+     */
+    inline void disable() const
+    {
+        bits::add(*controlStatusReg, bits::Bit7, ~bits::Bit4);
+    }
+
+    /**
+     * Set comparator positive input
+     */
+    inline void setPositiveInput(ComparatorPositive input) const
+    {
+        if (input == PositivePinAin0) {
+            bits::add(*controlStatusReg, ~bits::Bit6, ~bits::Bit4);
+        } else if (input == PositiveBandgap) {
+            bits::add(*controlStatusReg, bits::Bit6, ~bits::Bit4);
+        }
+    }
+
+    /**
+     * Set comparator negative input
+     * Multiplexer input is only available when
+     * the Adc is disabled. Selecting an Adc pin
+     * disables the Adc and overrides its input channel.
+     */
+    inline void setNegativeInput(ComparatorNegative input) const
+    {
+        if (input == NegativePinAin1) {
+            bits::add(*adcControlStatusBReg, ~bits::Bit6);
+            return;
+        }
+        if (input == NegativePinAdc0) {
+            bits::add(*multiplexerReg,
+                ~bits::Bit2, ~bits::Bit1, ~bits::Bit0);
+        } else if (input == NegativePinAdc1) {
+            bits::add(*multiplexerReg,
+                ~bits::Bit2, ~bits::Bit1, bits::Bit0);
+        } else if (input == NegativePinAdc2) {
+            bits::add(*multiplexerReg,
+                ~bits::Bit2, bits::Bit1, ~bits::Bit0);
+        } else if (input == NegativePinAdc3) {
+            bits::add(*multiplexerReg,
+                ~bits::Bit2, bits::Bit1, bits::Bit0);
+        } else if (input == NegativePinAdc4) {
+            bits::add(*multiplexerReg,
+                bits::Bit2, ~bits::Bit1, ~bits::Bit0);
+        } else if (input == NegativePinAdc5) {
+            bits::add(*multiplexerReg,
+                bits::Bit2, ~bits::Bit1, bits::Bit0);
+        }
+        bits::add(*adcControlStatusAReg, ~bits::Bit7);
+        bits::add(*adcControlStatusBReg, bits::Bit6);
+    }
+
+    /**
+     * Set the output edge firing the interrupt
+     * (The interrupt is disabled while the edge is
+     * changed in order to prevent spurious trigger)
+     */
+    inline void setEdge(ComparatorEdge edge) const
+    {
+        logic isEnabled = bits::get(*controlStatusReg, bits::Bit3);
+        bits::add(*controlStatusReg, ~bits::Bit3, ~bits::Bit4);
+        if (edge == EdgeToggle) {
+            bits::add(*controlStatusReg,
+                ~bits::Bit1, ~bits::Bit0, ~bits::Bit4);
+        } else if (edge == EdgeFalling) {
+            bits::add(*controlStatusReg,
+                bits::Bit1, ~bits::Bit0, ~bits::Bit4);
+        } else if (edge == EdgeRising) {
+            bits::add(*controlStatusReg,
+                bits::Bit1, bits::Bit0, ~bits::Bit4);
+        }
+        clearTrigger();
+        if (isEnabled == True) {
+            bits::add(*controlStatusReg, bits::Bit3, ~bits::Bit4);
+        }
+    }
+
+    /**
+     * Route (or not) the comparator output to
+     * Timer1 input capture unit. Captures are
+     * then triggered by the comparator instead of ICP1 pin
+     * (Capture edge and noise canceler are configured
+     * on Timer1)
+     */
+    inline void setCaptureCoupling(logic isCoupled) const
+    {
+        if (isCoupled == True) {
+            bits::add(*controlStatusReg, bits::Bit2, ~bits::Bit4);
+        } else {
+            bits::add(*controlStatusReg, ~bits::Bit2, ~bits::Bit4);
+        }
+    }
+
+    /**
+     * Return the comparator output
+     * (True when positive input is
+     * greater than negative input)
+     */
+    inline logic read() const
+    {
+        return bits::get(*controlStatusReg, bits::Bit5);
+    }
+
+    /**
+     * Return true when the configured output edge
+     * has occured
+     * The flag is cleared manually or when associated
+     * interruption is executed
+     */
+    inline logic isTrigger() const
+    {
+        return bits::get(*controlStatusReg, bits::Bit4);
+    }
+
+    /**
+     * Manually clear the trigger flag
+     */
+    inline void clearTrigger() const
+    {
+        bits::add(*controlStatusReg, bits::Bit4);
+    }
+
+    /**
+     * Initialize and set up interrupt routine
+     * with given callback fired when
+     * the configured output edge occured
+     * Or disable the interrupt
+     */
+    inline void onTrigger
+        (Handler::type handler = Handler::Disable)
+    {
+        onTriggerFunc = handler;
+        if (handler != Handler::Disable) {
+            bits::add(*controlStatusReg, bits::Bit3, ~bits::Bit4);
+        } else {
+            bits::add(*controlStatusReg, ~bits::Bit3, ~bits::Bit4);
+        }
+    }
+};
+
+/**
+ * Define const global object
+ * as Analog Comparator instance
+ */
+ComparatorObject AnalogComparator = {
+    &ACSR, &ADCSRA, &ADCSRB, &ADMUX, &DIDR1,
+    ComparatorObject::Handler::Disable
+};
+
+/**
+ * Define Analog Comparator interruptions handler
+ */
+ISR(ANALOG_COMP_vect)
+{
+    ISR_PROBE(isr::VectorComparator);
+    if (AnalogComparator.onTriggerFunc != ComparatorObject::Handler::Disable) {
+        AnalogComparator.onTriggerFunc(AnalogComparator);
+    }
+}
+
+}
+
+#endif
+
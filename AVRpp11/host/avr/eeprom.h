@@ -0,0 +1,38 @@
+#ifndef AVRPP11_HOST_EEPROM_H
+#define AVRPP11_HOST_EEPROM_H
+
+/**
+ * Host replacement of avr/eeprom.h
+ * (EEMEM variables are ordinary memory)
+ */
+#include <stdint.h>
+#include <string.h>
+
+#define EEMEM
+
+inline uint8_t eeprom_read_byte(const uint8_t* address)
+{
+    return *address;
+}
+inline void eeprom_write_byte(uint8_t* address, uint8_t value)
+{
+    *address = value;
+}
+inline void eeprom_update_byte(uint8_t* address, uint8_t value)
+{
+    *address = value;
+}
+inline void eeprom_read_block(void* dst, const void* src, size_t size)
+{
+    memcpy(dst, src, size);
+}
+inline void eeprom_write_block(const void* src, void* dst, size_t size)
+{
+    memcpy(dst, src, size);
+}
+inline void eeprom_update_block(const void* src, void* dst, size_t size)
+{
+    memcpy(dst, src, size);
+}
+
+#endif
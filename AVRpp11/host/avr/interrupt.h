@@ -0,0 +1,30 @@
+#ifndef AVRPP11_HOST_INTERRUPT_H
+#define AVRPP11_HOST_INTERRUPT_H
+
+/**
+ * Host replacement of avr/interrupt.h
+ * The global interrupt flag is the status
+ * register bit 7 and ISR() defines a handler
+ * registered for host::raise().
+ */
+#include <avr/io.h>
+
+#define sei() (SREG |= host::sregInterrupt)
+#define cli() (SREG &= ~host::sregInterrupt)
+
+#define ISR_BLOCK
+#define ISR_NOBLOCK
+#define ISR_NAKED
+
+/**
+ * The vector is expanded to its
+ * number before name concatenation
+ */
+#define ISR_HOST(vector) \
+    void hostIsr ## vector(); \
+    static host::IsrRegistration hostIsrRegistration ## vector( \
+        vector, hostIsr ## vector); \
+    void hostIsr ## vector()
+#define ISR(vector, ...) ISR_HOST(vector)
+
+#endif
@@ -0,0 +1,163 @@
+#ifndef AVRPP11_HOST_IO_H
+#define AVRPP11_HOST_IO_H
+
+/**
+ * Host replacement of avr/io.h for the ATmega328P
+ * Registers are mapped to the emulated register file
+ * at their data space address (see host.h).
+ */
+#include "../host.h"
+
+#define AVRPP11_HOST
+
+/**
+ * Register access
+ */
+#define _MMIO_BYTE(address) (host::registers[address])
+#define _MMIO_WORD(address) \
+    (*(volatile uint16_t*)&host::registers[address])
+#define _BV(bit) (1 << (bit))
+
+/**
+ * Cycle exact delay has no meaning on host
+ */
+#define __builtin_avr_delay_cycles(cycles) ((void)(cycles))
+
+/**
+ * Memory bounds
+ */
+#define RAMSTART 0x100
+#define RAMEND 0x8FF
+#define E2END 0x3FF
+#define FLASHEND 0x7FFF
+
+/**
+ * I/O registers
+ */
+#define PINB _MMIO_BYTE(0x23)
+#define DDRB _MMIO_BYTE(0x24)
+#define PORTB _MMIO_BYTE(0x25)
+#define PINC _MMIO_BYTE(0x26)
+#define DDRC _MMIO_BYTE(0x27)
+#define PORTC _MMIO_BYTE(0x28)
+#define PIND _MMIO_BYTE(0x29)
+#define DDRD _MMIO_BYTE(0x2A)
+#define PORTD _MMIO_BYTE(0x2B)
+#define TIFR0 _MMIO_BYTE(0x35)
+#define TIFR1 _MMIO_BYTE(0x36)
+#define TIFR2 _MMIO_BYTE(0x37)
+#define PCIFR _MMIO_BYTE(0x3B)
+#define EIFR _MMIO_BYTE(0x3C)
+#define EIMSK _MMIO_BYTE(0x3D)
+#define GPIOR0 _MMIO_BYTE(0x3E)
+#define EECR _MMIO_BYTE(0x3F)
+#define EEDR _MMIO_BYTE(0x40)
+#define EEAR _MMIO_WORD(0x41)
+#define EEARL _MMIO_BYTE(0x41)
+#define EEARH _MMIO_BYTE(0x42)
+#define GTCCR _MMIO_BYTE(0x43)
+#define TCCR0A _MMIO_BYTE(0x44)
+#define TCCR0B _MMIO_BYTE(0x45)
+#define TCNT0 _MMIO_BYTE(0x46)
+#define OCR0A _MMIO_BYTE(0x47)
+#define OCR0B _MMIO_BYTE(0x48)
+#define GPIOR1 _MMIO_BYTE(0x4A)
+#define GPIOR2 _MMIO_BYTE(0x4B)
+#define SPCR _MMIO_BYTE(0x4C)
+#define SPSR _MMIO_BYTE(0x4D)
+#define SPDR _MMIO_BYTE(0x4E)
+#define ACSR _MMIO_BYTE(0x50)
+#define SMCR _MMIO_BYTE(0x53)
+#define MCUSR _MMIO_BYTE(0x54)
+#define MCUCR _MMIO_BYTE(0x55)
+#define SPMCSR _MMIO_BYTE(0x57)
+#define SP _MMIO_WORD(0x5D)
+#define SPL _MMIO_BYTE(0x5D)
+#define SPH _MMIO_BYTE(0x5E)
+#define SREG _MMIO_BYTE(0x5F)
+#define WDTCSR _MMIO_BYTE(0x60)
+#define CLKPR _MMIO_BYTE(0x61)
+#define PRR _MMIO_BYTE(0x64)
+#define OSCCAL _MMIO_BYTE(0x66)
+#define PCICR _MMIO_BYTE(0x68)
+#define EICRA _MMIO_BYTE(0x69)
+#define PCMSK0 _MMIO_BYTE(0x6B)
+#define PCMSK1 _MMIO_BYTE(0x6C)
+#define PCMSK2 _MMIO_BYTE(0x6D)
+#define TIMSK0 _MMIO_BYTE(0x6E)
+#define TIMSK1 _MMIO_BYTE(0x6F)
+#define TIMSK2 _MMIO_BYTE(0x70)
+#define ADC _MMIO_WORD(0x78)
+#define ADCW _MMIO_WORD(0x78)
+#define ADCL _MMIO_BYTE(0x78)
+#define ADCH _MMIO_BYTE(0x79)
+#define ADCSRA _MMIO_BYTE(0x7A)
+#define ADCSRB _MMIO_BYTE(0x7B)
+#define ADMUX _MMIO_BYTE(0x7C)
+#define DIDR0 _MMIO_BYTE(0x7E)
+#define DIDR1 _MMIO_BYTE(0x7F)
+#define TCCR1A _MMIO_BYTE(0x80)
+#define TCCR1B _MMIO_BYTE(0x81)
+#define TCCR1C _MMIO_BYTE(0x82)
+#define TCNT1 _MMIO_WORD(0x84)
+#define TCNT1L _MMIO_BYTE(0x84)
+#define TCNT1H _MMIO_BYTE(0x85)
+#define ICR1 _MMIO_WORD(0x86)
+#define ICR1L _MMIO_BYTE(0x86)
+#define ICR1H _MMIO_BYTE(0x87)
+#define OCR1A _MMIO_WORD(0x88)
+#define OCR1AL _MMIO_BYTE(0x88)
+#define OCR1AH _MMIO_BYTE(0x89)
+#define OCR1B _MMIO_WORD(0x8A)
+#define OCR1BL _MMIO_BYTE(0x8A)
+#define OCR1BH _MMIO_BYTE(0x8B)
+#define TCCR2A _MMIO_BYTE(0xB0)
+#define TCCR2B _MMIO_BYTE(0xB1)
+#define TCNT2 _MMIO_BYTE(0xB2)
+#define OCR2A _MMIO_BYTE(0xB3)
+#define OCR2B _MMIO_BYTE(0xB4)
+#define ASSR _MMIO_BYTE(0xB6)
+#define TWBR _MMIO_BYTE(0xB8)
+#define TWSR _MMIO_BYTE(0xB9)
+#define TWAR _MMIO_BYTE(0xBA)
+#define TWDR _MMIO_BYTE(0xBB)
+#define TWCR _MMIO_BYTE(0xBC)
+#define TWAMR _MMIO_BYTE(0xBD)
+#define UCSR0A _MMIO_BYTE(0xC0)
+#define UCSR0B _MMIO_BYTE(0xC1)
+#define UCSR0C _MMIO_BYTE(0xC2)
+#define UBRR0 _MMIO_WORD(0xC4)
+#define UBRR0L _MMIO_BYTE(0xC4)
+#define UBRR0H _MMIO_BYTE(0xC5)
+#define UDR0 _MMIO_BYTE(0xC6)
+
+/**
+ * Interrupt vector numbers
+ */
+#define INT0_vect 1
+#define INT1_vect 2
+#define PCINT0_vect 3
+#define PCINT1_vect 4
+#define PCINT2_vect 5
+#define WDT_vect 6
+#define TIMER2_COMPA_vect 7
+#define TIMER2_COMPB_vect 8
+#define TIMER2_OVF_vect 9
+#define TIMER1_CAPT_vect 10
+#define TIMER1_COMPA_vect 11
+#define TIMER1_COMPB_vect 12
+#define TIMER1_OVF_vect 13
+#define TIMER0_COMPA_vect 14
+#define TIMER0_COMPB_vect 15
+#define TIMER0_OVF_vect 16
+#define SPI_STC_vect 17
+#define USART_RX_vect 18
+#define USART_UDRE_vect 19
+#define USART_TX_vect 20
+#define ADC_vect 21
+#define EE_READY_vect 22
+#define ANALOG_COMP_vect 23
+#define TWI_vect 24
+#define SPM_READY_vect 25
+
+#endif
@@ -0,0 +1,19 @@
+#ifndef AVRPP11_HOST_PGMSPACE_H
+#define AVRPP11_HOST_PGMSPACE_H
+
+/**
+ * Host replacement of avr/pgmspace.h
+ * (program memory is ordinary memory)
+ */
+#include <stdint.h>
+#include <string.h>
+
+#define PROGMEM
+#define PSTR(str) (str)
+#define pgm_read_byte(address) (*(const uint8_t*)(address))
+#define pgm_read_word(address) (*(const uint16_t*)(address))
+#define pgm_read_dword(address) (*(const uint32_t*)(address))
+#define memcpy_P memcpy
+#define strlen_P strlen
+
+#endif
@@ -0,0 +1,162 @@
+#ifndef AVRPP11_HOST_H
+#define AVRPP11_HOST_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * Host native backend runtime
+ *
+ * The avr-libc headers of AVRpp11/host replace
+ * the target ones (g++ -IAVRpp11/host) so that the
+ * library compiles natively. I/O registers are bytes of
+ * an emulated register file at their data space address,
+ * ISR() bodies are registered as callbacks raised by tests
+ * and peripheral models are functions called by step()
+ * which read and write the register file.
+ * Registers are plain memory: a model sees the effect
+ * of a write, not the write itself. Busy wait loops on
+ * status flags need the flag to be set beforehand
+ * (or by a model from an interrupt handler).
+ *
+ * host::reset();
+ * host::addModel(usartModel);
+ * Printer::init(usart::BaudRate9600);
+ * Printer::write("test");
+ * host::step(10);
+ */
+namespace host {
+
+/**
+ * Register file and SRAM sizes, vector
+ * count and maximum number of models
+ */
+constexpr size_t registerCount = 0x100;
+constexpr size_t sramSize = 0x900;
+constexpr uint8_t vectorCount = 26;
+constexpr uint8_t modelCount = 8;
+
+/**
+ * Stack pointer and status register
+ * addresses and global interrupt flag
+ */
+constexpr uint8_t spAddress = 0x5D;
+constexpr uint8_t sregAddress = 0x5F;
+constexpr uint8_t sregInterrupt = 0x80;
+
+/**
+ * Interrupt handler and peripheral model
+ */
+typedef void (*Handler)();
+
+/**
+ * Emulated register file, registered
+ * interrupt handlers and models
+ */
+volatile uint8_t registers[registerCount];
+Handler handlers[vectorCount];
+Handler models[modelCount];
+
+/**
+ * Emulated data space for code scanning
+ * memory by address (MemoryMonitor)
+ */
+uint8_t sram[sramSize];
+
+/**
+ * Register given handler for given vector
+ * (used by ISR() at static initialization)
+ */
+struct IsrRegistration {
+    IsrRegistration(uint8_t vector, Handler handler)
+    {
+        handlers[vector] = handler;
+    }
+};
+
+/**
+ * Call given vector handler as the hardware would
+ * (only if global interrupts are enabled unless forced,
+ * with interrupts disabled during the handler and the
+ * status register restored after).
+ * Return true if a handler has been called.
+ */
+inline bool raise(uint8_t vector, bool isForced = false)
+{
+    uint8_t sreg = registers[sregAddress];
+    if (vector >= vectorCount || handlers[vector] == nullptr ||
+        (!isForced && (sreg & sregInterrupt) == 0)
+    ) {
+        return false;
+    }
+    registers[sregAddress] = sreg & ~sregInterrupt;
+    handlers[vector]();
+    registers[sregAddress] = sreg;
+    return true;
+}
+
+/**
+ * Add a peripheral model called at each step
+ * Return false if no slot is available
+ */
+inline bool addModel(Handler model)
+{
+    for (uint8_t i=0;i<modelCount;i++) {
+        if (models[i] == nullptr) {
+            models[i] = model;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Call all models given number of times
+ */
+inline void step(unsigned long count = 1)
+{
+    for (unsigned long n=0;n<count;n++) {
+        for (uint8_t i=0;i<modelCount;i++) {
+            if (models[i] != nullptr) {
+                models[i]();
+            }
+        }
+    }
+}
+
+/**
+ * Clear the register file and SRAM, set
+ * the stack pointer to the end of SRAM and
+ * remove the models (handlers are kept)
+ */
+inline void reset()
+{
+    for (size_t i=0;i<registerCount;i++) {
+        registers[i] = 0;
+    }
+    for (size_t i=0;i<sramSize;i++) {
+        sram[i] = 0;
+    }
+    registers[spAddress] = (sramSize - 1) & 0xFF;
+    registers[spAddress + 1] = (sramSize - 1) >> 8;
+    for (uint8_t i=0;i<modelCount;i++) {
+        models[i] = nullptr;
+    }
+}
+
+/**
+ * avr-libc linker symbols (empty .data,
+ * .bss and heap at the start of the SRAM,
+ * in the host namespace as the host C library
+ * defines its own __data_start)
+ */
+uint8_t& __data_start = sram[0x100];
+uint8_t& __data_end = sram[0x100];
+uint8_t& __bss_start = sram[0x100];
+uint8_t& __bss_end = sram[0x100];
+uint8_t& __heap_start = sram[0x100];
+uint8_t* __brkval = nullptr;
+
+}
+
+#endif
@@ -0,0 +1,15 @@
+#ifndef AVRPP11_HOST_DELAY_H
+#define AVRPP11_HOST_DELAY_H
+
+/**
+ * Host replacement of util/delay.h
+ * (delays return immediately)
+ */
+inline void _delay_us(double)
+{
+}
+inline void _delay_ms(double)
+{
+}
+
+#endif
@@ -47,13 +47,190 @@ inline void disable()
  */
 inline logic getState()
 {
-    bits::get(SREG, bits::Bit7);
+    return bits::get(SREG, bits::Bit7);
 }
 inline void setState(logic val)
 {
     bits::set(SREG, bits::Bit7, val);
 }
 
+#if defined(AVRPP11_ISR_STATS) || defined(AVRPP11_ISR_TRACE)
+
+/**
+ * Instrumented interrupt vectors
+ */
+enum Vector : byte {
+    VectorAdc,
+    VectorComparator,
+    VectorSpi,
+    VectorTimer0MatchA,
+    VectorTimer0MatchB,
+    VectorTimer0Overflow,
+    VectorTimer1MatchA,
+    VectorTimer1MatchB,
+    VectorTimer1Overflow,
+    VectorTimer1Capture,
+    VectorTimer2MatchA,
+    VectorTimer2MatchB,
+    VectorTimer2Overflow,
+    VectorUsartReadReady,
+    VectorUsartWriteReady,
+    VectorUsartDataSent,
+    VectorCount,
+};
+
+#endif
+
+#ifdef AVRPP11_ISR_STATS
+
+/**
+ * Per vector statistics
+ * (AVRPP11_ISR_STATS compilation flag)
+ * Handler durations are measured in cpu cycles
+ * with Timer1 counter, which has to be free running
+ * without prescaler (SystemClock). Interrupt entry and
+ * register save/restore (about 40 cycles) are not
+ * included. The max duration is also the latency
+ * the vector can add to other interrupts.
+ */
+struct VectorStats {
+    uint32_t count;
+    uint32_t total;
+    word max;
+};
+VectorStats vectorStats[VectorCount];
+
+/**
+ * Return given vector statistics
+ * or reset all vectors statistics
+ */
+inline VectorStats getStats(Vector vector)
+{
+    logic state = getState();
+    disable();
+    VectorStats stats = vectorStats[vector];
+    setState(state);
+    return stats;
+}
+inline void resetStats()
+{
+    logic state = getState();
+    disable();
+    for (byte i=0;i<VectorCount;i++) {
+        vectorStats[i] = {0, 0, 0};
+    }
+    setState(state);
+}
+
+/**
+ * Return given vector cpu load in 1/10000
+ * over given number of cpu cycles elapsed
+ * since the last statistics reset
+ * (both are scaled down to keep 32 bits math)
+ */
+inline word getLoad(Vector vector, uint32_t elapsed)
+{
+    uint32_t total = getStats(vector).total;
+    while (total > 0xFFFFFFFF/10000) {
+        total >>= 1;
+        elapsed >>= 1;
+    }
+    if (elapsed == 0) {
+        return 0;
+    }
+    return (total*10000)/elapsed;
+}
+
+#endif
+
+#ifdef AVRPP11_ISR_TRACE
+
+/**
+ * Per vector trace pin output register
+ * and mask (AVRPP11_ISR_TRACE compilation flag)
+ * The pin is high while the handler runs.
+ */
+bytePtr tracePorts[VectorCount];
+byte traceMasks[VectorCount];
+
+/**
+ * Set given Gpio pin (set in output mode)
+ * as given vector trace pin
+ */
+template <class Pin>
+inline void setTracePin(Vector vector, const Pin& pin)
+{
+    logic state = getState();
+    disable();
+    bits::add(*pin.outReg, ~pin.num);
+    bits::add(*pin.dirReg, pin.num);
+    tracePorts[vector] = pin.outReg;
+    traceMasks[vector] = bits::value<byte>(pin.num);
+    setState(state);
+}
+
+#endif
+
+#if defined(AVRPP11_ISR_STATS) || defined(AVRPP11_ISR_TRACE)
+
+/**
+ * Instrumentation of an interrupt handler
+ * scope (statistics and/or trace pin)
+ */
+class Probe
+{
+    public:
+
+        inline Probe(Vector vector) :
+            _vector(vector)
+        {
+#ifdef AVRPP11_ISR_TRACE
+            if (tracePorts[_vector] != nullptr) {
+                *tracePorts[_vector] |= traceMasks[_vector];
+            }
+#endif
+#ifdef AVRPP11_ISR_STATS
+            _start = TCNT1;
+#endif
+        }
+        inline ~Probe()
+        {
+#ifdef AVRPP11_ISR_STATS
+            word cycles = TCNT1 - _start;
+            VectorStats& stats = vectorStats[_vector];
+            stats.count++;
+            stats.total += cycles;
+            if (cycles > stats.max) {
+                stats.max = cycles;
+            }
+#endif
+#ifdef AVRPP11_ISR_TRACE
+            if (tracePorts[_vector] != nullptr) {
+                *tracePorts[_vector] &= ~traceMasks[_vector];
+            }
+#endif
+        }
+
+    private:
+
+        const Vector _vector;
+#ifdef AVRPP11_ISR_STATS
+        word _start;
+#endif
+};
+
+/**
+ * Instrument the enclosing interrupt handler
+ * (no code without instrumentation flags)
+ */
+#define ISR_PROBE(vector) isr::Probe isrProbe(vector)
+
+#else
+
+#define ISR_PROBE(vector)
+
+#endif
+
 }
 
 #endif
@@ -0,0 +1,318 @@
+#ifndef ADCCAPTURE_HPP
+#define ADCCAPTURE_HPP
+
+/**
+ * Oscilloscope like Adc capture
+ *
+ * The Adc runs in free running mode and
+ * every sample is pushed into a circular
+ * pre-trigger history. The trigger condition
+ * is evaluated per sample in the Adc interrupt.
+ * Once triggered, the given number of post-trigger
+ * samples are recorded and the buffer is frozen
+ * until it is read or streamed over Usart0.
+ *
+ * The per sample handler only costs a few
+ * dozen cycles and sustains free running
+ * conversions down to the 16 prescaler.
+ */
+class AdcCapture
+{
+    public:
+
+        /**
+         * Capture trigger condition
+         * Rising : the sample crosses the threshold upward
+         * after having been below threshold minus hysteresis
+         * Falling : the sample crosses the threshold downward
+         * after having been above threshold plus hysteresis
+         * SlopeUp : the difference between two consecutive
+         * samples is greater or equal to the threshold
+         * SlopeDown : the difference between two consecutive
+         * samples is lower or equal to minus the threshold
+         * Comparator : the Analog Comparator configured edge
+         * has occured (its interrupt must be disabled)
+         * Force : trigger on the next sample
+         */
+        enum Trigger : byte {
+            TriggerRising,
+            TriggerFalling,
+            TriggerSlopeUp,
+            TriggerSlopeDown,
+            TriggerComparator,
+            TriggerForce,
+        };
+
+        /**
+         * Capture state
+         * Stopped : the Adc is not sampling
+         * Filling : the pre-trigger history is not full yet
+         * Armed : waiting for the trigger condition
+         * Triggered : recording post-trigger samples
+         * Frozen : the buffer is complete and stable
+         */
+        enum State : byte {
+            StateStopped,
+            StateFilling,
+            StateArmed,
+            StateTriggered,
+            StateFrozen,
+        };
+
+        /**
+         * Define capture circular buffer size
+         * (256 makes the byte index wrap for free)
+         */
+        static constexpr word bufferSize = 256;
+        static_assert(bufferSize == 256, 
+            "AdcCapture index relies on byte overflow");
+
+        /**
+         * Start free running conversions on given
+         * Adc input (the reference has to be configured)
+         * and arm the capture with given trigger,
+         * threshold, hysteresis (Rising and Falling only),
+         * number of post-trigger samples and Adc clock
+         * prescaler (13 Adc clocks per sample)
+         */
+        static inline void start(adc::AdcInput input,
+            Trigger trigger, word threshold, word hysteresis,
+            byte postCount,
+            adc::AdcPrescaler prescaler = adc::PrescalerDiv128)
+        {
+            isr::disable();
+            adc::Adc.setTrigger(adc::TriggerSingle);
+            adc::Adc.onConversionComplete();
+            _trigger = trigger;
+            _threshold = threshold;
+            if (trigger == TriggerRising) {
+                _rearm = threshold > hysteresis ?
+                    threshold - hysteresis : 0;
+            } else {
+                _rearm = threshold + hysteresis;
+            }
+            _isRearmed = False;
+            _postCount = postCount;
+            _fillCount = bufferSize - postCount;
+            _head = 0;
+            _triggerIndex = 0;
+            _state = StateFilling;
+            comparator::AnalogComparator.clearTrigger();
+            adc::Adc.setInput(input);
+            adc::Adc.enable();
+            adc::Adc.setPrescaler(prescaler);
+            adc::Adc.setTrigger(adc::TriggerFreeRunning);
+            adc::Adc.onConversionComplete(AdcCapture::isrHandler);
+            adc::Adc.startConversion();
+            isr::enable();
+        }
+
+        /**
+         * Stop the sampling
+         */
+        static inline void stop()
+        {
+            isr::disable();
+            adc::Adc.setTrigger(adc::TriggerSingle);
+            adc::Adc.onConversionComplete();
+            if (_state != StateFrozen) {
+                _state = StateStopped;
+            }
+            isr::enable();
+        }
+
+        /**
+         * Trigger the capture on next sample
+         * regardless of the trigger condition
+         */
+        static inline void force()
+        {
+            _trigger = TriggerForce;
+        }
+
+        /**
+         * Return current capture state
+         */
+        static inline State getState()
+        {
+            return _state;
+        }
+
+        /**
+         * Return true when the post-trigger
+         * samples are recorded
+         */
+        static inline logic isFrozen()
+        {
+            return logic_cast((byte)(_state == StateFrozen));
+        }
+
+        /**
+         * Return the frozen sample at given
+         * chronological index (0 is the oldest)
+         */
+        static inline word read(byte index)
+        {
+            return _buffer[(byte)(_head + index)];
+        }
+
+        /**
+         * Return the chronological index
+         * of the triggering sample
+         */
+        static inline byte getTriggerIndex()
+        {
+            return _triggerIndex - _head;
+        }
+
+        /**
+         * Send the frozen buffer as binary stream
+         * over Usart0 (configured in write mode
+         * and with Printer output flushed).
+         * Trigger index is sent first followed
+         * by all samples from the oldest, low byte first.
+         */
+        static inline void stream()
+        {
+            streamByte(getTriggerIndex());
+            for (word i=0;i<bufferSize;i++) {
+                word sample = read(i);
+                streamByte(sample & 0xFF);
+                streamByte(sample >> 8);
+            }
+            while (!usart::Usart0.isDataSent());
+        }
+
+        /**
+         * Adc conversion completed interrupt handler
+         */
+        static void isrHandler(HandlerArg(adc::Adc) a)
+        {
+            word sample = a.readValue();
+            byte index = _head;
+            _buffer[index] = sample;
+            _head = index + 1;
+
+            State state = _state;
+            if (state == StateTriggered) {
+                _remainingCount--;
+                if (_remainingCount == 0) {
+                    freeze(a);
+                }
+                return;
+            }
+            if (state == StateFilling) {
+                _fillCount--;
+                if (_fillCount == 0) {
+                    _state = StateArmed;
+                    comparator::AnalogComparator.clearTrigger();
+                }
+                _previous = sample;
+                return;
+            }
+
+            logic isTrigger = False;
+            if (_trigger == TriggerRising) {
+                if (sample < _rearm) {
+                    _isRearmed = True;
+                } else if (_isRearmed && sample >= _threshold) {
+                    isTrigger = True;
+                }
+            } else if (_trigger == TriggerFalling) {
+                if (sample > _rearm) {
+                    _isRearmed = True;
+                } else if (_isRearmed && sample <= _threshold) {
+                    isTrigger = True;
+                }
+            } else if (_trigger == TriggerSlopeUp) {
+                isTrigger = logic_cast((byte)(
+                    (sword)(sample - _previous) >= (sword)_threshold));
+            } else if (_trigger == TriggerSlopeDown) {
+                isTrigger = logic_cast((byte)(
+                    (sword)(_previous - sample) >= (sword)_threshold));
+            } else if (_trigger == TriggerComparator) {
+                isTrigger = comparator::AnalogComparator.isTrigger();
+            } else if (_trigger == TriggerForce) {
+                isTrigger = True;
+            }
+            _previous = sample;
+
+            if (isTrigger == True) {
+                _triggerIndex = index;
+                _remainingCount = _postCount;
+                if (_remainingCount == 0) {
+                    freeze(a);
+                } else {
+                    _state = StateTriggered;
+                }
+            }
+        }
+
+    private:
+
+        /**
+         * Capture circular buffer
+         * and next write index
+         */
+        static volatile word _buffer[bufferSize];
+        static volatile byte _head;
+
+        /**
+         * Trigger configuration
+         */
+        static volatile Trigger _trigger;
+        static volatile word _threshold;
+        static volatile word _rearm;
+        static volatile logic _isRearmed;
+        static volatile word _previous;
+
+        /**
+         * Capture state, remaining samples
+         * to fill or record and trigger position
+         */
+        static volatile State _state;
+        static volatile word _fillCount;
+        static volatile byte _postCount;
+        static volatile byte _remainingCount;
+        static volatile byte _triggerIndex;
+
+        /**
+         * Stop the Adc and freeze the buffer
+         */
+        static inline void freeze(HandlerArg(adc::Adc) a)
+        {
+            _state = StateFrozen;
+            a.setTrigger(adc::TriggerSingle);
+            a.onConversionComplete();
+        }
+
+        /**
+         * Write a byte on Usart0 when ready
+         */
+        static inline void streamByte(byte value)
+        {
+            while (!usart::Usart0.isWriteReady());
+            usart::Usart0.write(value);
+        }
+};
+
+/**
+ * Non const member definition
+ */
+volatile word AdcCapture::_buffer[AdcCapture::bufferSize];
+volatile byte AdcCapture::_head = 0;
+volatile AdcCapture::Trigger AdcCapture::_trigger =
+    AdcCapture::TriggerForce;
+volatile word AdcCapture::_threshold = 0;
+volatile word AdcCapture::_rearm = 0;
+volatile logic AdcCapture::_isRearmed = False;
+volatile word AdcCapture::_previous = 0;
+volatile AdcCapture::State AdcCapture::_state =
+    AdcCapture::StateStopped;
+volatile word AdcCapture::_fillCount = 0;
+volatile byte AdcCapture::_postCount = 0;
+volatile byte AdcCapture::_remainingCount = 0;
+volatile byte AdcCapture::_triggerIndex = 0;
+
+#endif
+
@@ -0,0 +1,127 @@
+#ifndef COROUTINE_HPP
+#define COROUTINE_HPP
+
+/**
+ * Stackless resumable functions
+ * (protothread style) for multi step drivers
+ *
+ * A coroutine is a class inheriting Coroutine whose
+ * members hold the state kept between steps (locals
+ * of the resume function are not preserved) and whose
+ * resume function body is written linearly between
+ * CO_BEGIN() and CO_END(). The resume point is a single
+ * byte and resuming costs one switch dispatch, like
+ * a hand written state machine.
+ * Resume can be called from an interrupt handler (each
+ * call then runs the next step of the transaction) or
+ * polled from the main loop or an EventLoop work item.
+ *
+ * struct Blink : public Coroutine {
+ *     byte count;
+ *     void resume() {
+ *         CO_BEGIN();
+ *         for (count=0;count<10;count++) {
+ *             gpio::D13.toggle();
+ *             CO_AWAIT(timer::Timer0.isOverflow());
+ *             timer::Timer0.clearOverflow();
+ *         }
+ *         CO_END();
+ *     }
+ * };
+ *
+ * CO_YIELD and CO_AWAIT can not be used
+ * inside a switch statement of the body.
+ */
+class Coroutine
+{
+    public:
+
+        /**
+         * Make the coroutine start from the
+         * beginning at next resume
+         */
+        inline void start()
+        {
+            _coState = Start;
+        }
+
+        /**
+         * Stop the coroutine
+         * (next resumes do nothing)
+         */
+        inline void stop()
+        {
+            _coState = Done;
+        }
+
+        /**
+         * Return true if the coroutine has been
+         * started and has not reached its end
+         */
+        inline logic isRunning() const
+        {
+            return logic_cast((byte)(_coState != Done));
+        }
+
+    protected:
+
+        /**
+         * Resume point values
+         * (steps are numbered from one)
+         */
+        static constexpr byte Start = 0;
+        static constexpr byte Done = 0xFF;
+
+        /**
+         * Current resume point
+         * (stopped by default)
+         */
+        volatile byte _coState = Done;
+};
+
+/**
+ * Start the coroutine body
+ * (the step base is a compile time
+ * counter snapshot)
+ */
+#define CO_BEGIN() \
+    enum { CoBase = __COUNTER__ }; \
+    switch (_coState) { \
+        case Coroutine::Done: \
+            return; \
+        case Coroutine::Start:
+
+/**
+ * Suspend until next resume
+ * (typically next peripheral event when
+ * resumed from its interrupt handler)
+ */
+#define CO_YIELD() \
+    do { \
+        _coState = __COUNTER__ - CoBase; \
+        return; \
+        case __COUNTER__ - CoBase - 1:; \
+    } while (0)
+
+/**
+ * Suspend until given condition is true
+ * (the condition is checked at each resume)
+ */
+#define CO_AWAIT(cond) \
+    do { \
+        _coState = __COUNTER__ - CoBase; \
+        case __COUNTER__ - CoBase - 1: \
+        if (!(cond)) { \
+            return; \
+        } \
+    } while (0)
+
+/**
+ * End the coroutine body
+ */
+#define CO_END() \
+    } \
+    _coState = Coroutine::Done
+
+#endif
+
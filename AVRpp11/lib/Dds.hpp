@@ -0,0 +1,277 @@
+#ifndef DDS_HPP
+#define DDS_HPP
+
+#include <avr/pgmspace.h>
+#include "MCP4822.hpp"
+
+/**
+ * Direct digital synthesis waveform generator
+ * on both MCP4822 channels
+ *
+ * Each channel has a 32 bits phase accumulator
+ * incremented at a fixed sample rate (frequency
+ * resolution is sampleRate/2^32, 0.01mHz at 40kHz).
+ * The 8 high phase bits index a 256 entries PROGMEM
+ * wavetable (12 bits samples) and the 8 next bits linearly
+ * interpolate between two entries. Sine is built in,
+ * triangle, sawtooth and square are computed from the
+ * phase and arbitrary waveforms use a user table.
+ * Samples are computed in the MCP4822 stream timer
+ * interrupt (Timer1 owned, hardware latched LDAC on OC1A,
+ * see MCP4822::startStream) and sent with polled Spi.
+ * Per sample budget at 16MHz (both channels) is about
+ * 50 cycles of interrupt dispatch, 45 cycles per table
+ * channel (accumulator, two lpm and interpolation) and
+ * 130 cycles of polled frames, 270 cycles overall:
+ * sample rates up to about 50kHz can be used.
+ * (MCP4822 has to be initialized with OC1A latch pin)
+ */
+class Dds
+{
+    public:
+
+        /**
+         * Output channel waveform
+         * Table : user PROGMEM table (setTable)
+         */
+        enum Waveform : byte {
+            WaveSine,
+            WaveTriangle,
+            WaveSawtooth,
+            WaveSquare,
+            WaveTable,
+        };
+
+        /**
+         * Number of wavetable entries
+         */
+        static constexpr word tableSize = 256;
+
+        /**
+         * Built in 12 bits sine table
+         */
+        static const word sineTable[tableSize];
+
+        /**
+         * Start generation at given sample rate in
+         * Hertz (both channels are sine at 0Hz)
+         * Return the actual sample rate (zero if given
+         * rate can not be reached)
+         */
+        static inline uint32_t start(uint32_t sampleRate)
+        {
+            for (byte c=0;c<2;c++) {
+                _phases[c] = 0;
+                _steps[c] = 0;
+                _waveforms[c] = WaveSine;
+                _tables[c] = sineTable;
+            }
+            _sampleRate = MCP4822::startStream(sampleRate, 
+                MCP4822::StreamBoth);
+            if (_sampleRate != 0) {
+                timer::Timer1.onMatchA(Dds::isrHandler);
+            }
+            return _sampleRate;
+        }
+
+        /**
+         * Stop generation
+         * (last output is kept)
+         */
+        static inline void stop()
+        {
+            MCP4822::stopStream();
+        }
+
+        /**
+         * Set given channel waveform or user
+         * table (tableSize PROGMEM 12 bits samples)
+         */
+        static inline void setWaveform(MCP4822::Channel channel,
+            Waveform waveform)
+        {
+            _waveforms[channel] = waveform;
+        }
+        static inline void setTable(MCP4822::Channel channel,
+            const word* table)
+        {
+            logic state = isr::getState();
+            isr::disable();
+            _tables[channel] = table;
+            _waveforms[channel] = WaveTable;
+            isr::setState(state);
+        }
+
+        /**
+         * Set given channel frequency in milliHertz
+         * (at most half the sample rate) or directly
+         * its phase increment per sample
+         */
+        static inline void setFrequency(MCP4822::Channel channel,
+            uint32_t milliHertz)
+        {
+            if (_sampleRate == 0) {
+                return;
+            }
+            setStep(channel, stepFromFrequency(milliHertz, _sampleRate));
+        }
+        static inline void setStep(MCP4822::Channel channel, uint32_t step)
+        {
+            logic state = isr::getState();
+            isr::disable();
+            _steps[channel] = step;
+            isr::setState(state);
+        }
+
+        /**
+         * Set given channel phase in 1/65536 turn
+         * (or both channels relative phase when
+         * written at the same frequency)
+         */
+        static inline void setPhase(MCP4822::Channel channel, word phase)
+        {
+            logic state = isr::getState();
+            isr::disable();
+            _phases[channel] = (uint32_t)phase << 16;
+            isr::setState(state);
+        }
+
+        /**
+         * Return the phase increment per sample of
+         * given frequency in milliHertz at given sample
+         * rate in Hertz (at most 2MHz): milliHertz*2^32/
+         * (sampleRate*1000) rounded down, computed by 32 bits
+         * long division (about 400 cycles)
+         */
+        static inline uint32_t stepFromFrequency(uint32_t milliHertz,
+            uint32_t sampleRate)
+        {
+            uint32_t divisor = sampleRate*1000;
+            uint32_t remainder = milliHertz % divisor;
+            uint32_t step = 0;
+            for (byte i=0;i<32;i++) {
+                remainder <<= 1;
+                step <<= 1;
+                if (remainder >= divisor) {
+                    remainder -= divisor;
+                    step |= 1;
+                }
+            }
+            return step;
+        }
+
+        /**
+         * Return the actual sample rate and frequency
+         * resolution in microHertz (sampleRate*10^6/2^32,
+         * sample rates below 274kHz)
+         */
+        static inline uint32_t getSampleRate()
+        {
+            return _sampleRate;
+        }
+        static inline uint32_t getResolutionMicroHertz()
+        {
+            return (_sampleRate*15625UL) >> 26;
+        }
+
+        /**
+         * Timer1 compare A interrupt handler
+         * (LDAC pulse just ended, send next samples
+         * latched by the next hardware LDAC pulse)
+         */
+        static void isrHandler(HandlerArg(timer::Timer1) t)
+        {
+            word valueA = sample(MCP4822::ChannelA);
+            word valueB = sample(MCP4822::ChannelB);
+            MCP4822::sendBoth(valueA, valueB);
+        }
+
+    private:
+
+        /**
+         * Channels phase accumulator,
+         * phase increment, waveform and table
+         */
+        static uint32_t _phases[2];
+        static uint32_t _steps[2];
+        static Waveform _waveforms[2];
+        static const word* _tables[2];
+
+        /**
+         * Actual sample rate in Hertz
+         */
+        static uint32_t _sampleRate;
+
+        /**
+         * Advance given channel phase
+         * and return its 12 bits sample
+         */
+        static inline word sample(byte channel)
+        {
+            uint32_t phase = _phases[channel];
+            _phases[channel] = phase + _steps[channel];
+            word high = phase >> 16;
+            Waveform waveform = _waveforms[channel];
+            if (waveform == WaveTriangle) {
+                word ramp = high >> 3;
+                return ramp < 4096 ? ramp : 8191 - ramp;
+            } else if (waveform == WaveSawtooth) {
+                return high >> 4;
+            } else if (waveform == WaveSquare) {
+                return (high & 0x8000) ? 4095 : 0;
+            }
+            //Linear interpolation between two table entries
+            const word* table = _tables[channel];
+            byte index = high >> 8;
+            byte fraction = high & 0xFF;
+            sword first = pgm_read_word(table + index);
+            sword second = pgm_read_word(table + (byte)(index + 1));
+            return first + (((int32_t)(second - first)*fraction) >> 8);
+        }
+};
+
+/**
+ * Non const member definition
+ */
+const word Dds::sineTable[Dds::tableSize] PROGMEM = {
+            2048, 2098, 2148, 2198, 2248, 2298, 2348, 2398,
+            2447, 2496, 2545, 2594, 2642, 2690, 2737, 2784,
+            2831, 2877, 2923, 2968, 3013, 3057, 3100, 3143,
+            3185, 3226, 3267, 3307, 3346, 3385, 3423, 3459,
+            3495, 3530, 3565, 3598, 3630, 3662, 3692, 3722,
+            3750, 3777, 3804, 3829, 3853, 3876, 3898, 3919,
+            3939, 3958, 3975, 3992, 4007, 4021, 4034, 4045,
+            4056, 4065, 4073, 4080, 4085, 4089, 4093, 4094,
+            4095, 4094, 4093, 4089, 4085, 4080, 4073, 4065,
+            4056, 4045, 4034, 4021, 4007, 3992, 3975, 3958,
+            3939, 3919, 3898, 3876, 3853, 3829, 3804, 3777,
+            3750, 3722, 3692, 3662, 3630, 3598, 3565, 3530,
+            3495, 3459, 3423, 3385, 3346, 3307, 3267, 3226,
+            3185, 3143, 3100, 3057, 3013, 2968, 2923, 2877,
+            2831, 2784, 2737, 2690, 2642, 2594, 2545, 2496,
+            2447, 2398, 2348, 2298, 2248, 2198, 2148, 2098,
+            2048, 1997, 1947, 1897, 1847, 1797, 1747, 1697,
+            1648, 1599, 1550, 1501, 1453, 1405, 1358, 1311,
+            1264, 1218, 1172, 1127, 1082, 1038, 995, 952,
+            910, 869, 828, 788, 749, 710, 672, 636,
+            600, 565, 530, 497, 465, 433, 403, 373,
+            345, 318, 291, 266, 242, 219, 197, 176,
+            156, 137, 120, 103, 88, 74, 61, 50,
+            39, 30, 22, 15, 10, 6, 2, 1,
+            0, 1, 2, 6, 10, 15, 22, 30,
+            39, 50, 61, 74, 88, 103, 120, 137,
+            156, 176, 197, 219, 242, 266, 291, 318,
+            345, 373, 403, 433, 465, 497, 530, 565,
+            600, 636, 672, 710, 749, 788, 828, 869,
+            910, 952, 995, 1038, 1082, 1127, 1172, 1218,
+            1264, 1311, 1358, 1405, 1453, 1501, 1550, 1599,
+            1648, 1697, 1747, 1797, 1847, 1897, 1947, 1997
+};
+uint32_t Dds::_phases[2];
+uint32_t Dds::_steps[2];
+Dds::Waveform Dds::_waveforms[2];
+const word* Dds::_tables[2];
+uint32_t Dds::_sampleRate = 0;
+
+#endif
+
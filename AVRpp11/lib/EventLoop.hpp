@@ -0,0 +1,270 @@
+#ifndef EVENTLOOP_HPP
+#define EVENTLOOP_HPP
+
+#include <avr/sleep.h>
+#include "SystemClock.hpp"
+
+/**
+ * Cooperative event loop running deferred
+ * work items posted from interrupt handlers
+ * or from the main context
+ *
+ * Each priority has its own ring buffer. Interrupt
+ * handlers (non nested) only write a slot and move
+ * the head index, the main loop is the only consumer
+ * and moves the tail index, so the consumer never
+ * disables interrupts (posts from the main context
+ * are shortly protected against handlers).
+ * The highest priority non empty queue is always
+ * served first and the cpu sleeps when every
+ * queue is empty.
+ * Post to dispatch latency is recorded per priority
+ * using SystemClock (has to be initialized first).
+ */
+class EventLoop
+{
+    public:
+
+        /**
+         * Work item function called with
+         * the data given at post time
+         */
+        typedef void (*Work)(word data);
+
+        /**
+         * Idle hook called before
+         * the cpu enters sleep
+         */
+        typedef void (*Hook)();
+
+        /**
+         * Work item priority
+         * (High is served first)
+         */
+        enum Priority : byte {
+            PriorityHigh,
+            PriorityNormal,
+            PriorityLow,
+        };
+
+        /**
+         * Define the number of priorities and the
+         * queue size per priority (has to be a power of two)
+         */
+        static constexpr byte priorityCount = 3;
+        static constexpr byte queueSize = 8;
+        static_assert((queueSize & (queueSize-1)) == 0,
+            "EventLoop queueSize has to be a power of two");
+
+        /**
+         * Per priority statistics
+         * count : dispatched work items
+         * lostCount : posts dropped on full queue
+         * maxLatency and totalLatency : post to
+         * dispatch delay in cpu cycles
+         */
+        struct Stats {
+            word count;
+            word lostCount;
+            uint32_t maxLatency;
+            uint32_t totalLatency;
+        };
+
+        /**
+         * Queue given work item with given data
+         * at given priority.
+         * Return false if the queue is full.
+         * (Can be called from interrupt context)
+         */
+        static inline logic post(Work work,
+            word data = 0, Priority priority = PriorityNormal)
+        {
+            logic state = isr::getState();
+            isr::disable();
+            byte head = _heads[priority];
+            byte next = (head + 1) & (queueSize-1);
+            if (next == _tails[priority]) {
+                _stats[priority].lostCount++;
+                isr::setState(state);
+                return False;
+            }
+            volatile Item& item = _queues[priority][head];
+            item.work = work;
+            item.data = data;
+            item.time = SystemClock::cycles();
+            _heads[priority] = next;
+            isr::setState(state);
+            return True;
+        }
+
+        /**
+         * Return true if at least
+         * one work item is queued
+         */
+        static inline logic isPending()
+        {
+            for (byte p=0;p<priorityCount;p++) {
+                if (_heads[p] != _tails[p]) {
+                    return True;
+                }
+            }
+            return False;
+        }
+
+        /**
+         * Run the highest priority queued work item
+         * and return true or return false if every
+         * queue is empty
+         */
+        static inline logic runOnce()
+        {
+            for (byte p=0;p<priorityCount;p++) {
+                byte tail = _tails[p];
+                if (tail == _heads[p]) {
+                    continue;
+                }
+                volatile Item& item = _queues[p][tail];
+                Work work = item.work;
+                word data = item.data;
+                uint32_t latency = SystemClock::cycles() - item.time;
+                _tails[p] = (tail + 1) & (queueSize-1);
+                Stats& stats = _stats[p];
+                stats.count++;
+                stats.totalLatency += latency;
+                if (latency > stats.maxLatency) {
+                    stats.maxLatency = latency;
+                }
+                work(data);
+                return True;
+            }
+            return False;
+        }
+
+        /**
+         * Run work items forever
+         * and sleep when idle
+         */
+        static inline void run()
+        {
+            while (1) {
+                if (!runOnce()) {
+                    idle();
+                }
+            }
+        }
+
+        /**
+         * Call the idle hook and enter sleep mode
+         * unless a work item has been posted meanwhile.
+         * The cpu is woken up by the next interrupt.
+         * (Interrupts are enabled right before the sleep
+         * instruction which is always executed before any
+         * pending interrupt, so no post can be missed)
+         */
+        static inline void idle()
+        {
+            if (_onIdleFunc != nullptr) {
+                _onIdleFunc();
+            }
+            isr::disable();
+            if (isPending() == True || !_isSleep) {
+                isr::enable();
+                return;
+            }
+            set_sleep_mode(_sleepMode);
+            sleep_enable();
+            isr::enable();
+            sleep_cpu();
+            sleep_disable();
+        }
+
+        /**
+         * Set the sleep mode used when idle
+         * (SLEEP_MODE_IDLE by default, deeper modes
+         * stop Timer1 and SystemClock) or disable
+         * sleep (busy loop)
+         */
+        static inline void setSleepMode(byte mode)
+        {
+            _sleepMode = mode;
+            _isSleep = True;
+        }
+        static inline void disableSleep()
+        {
+            _isSleep = False;
+        }
+
+        /**
+         * Set or disable the idle hook
+         */
+        static inline void onIdle(Hook func = nullptr)
+        {
+            _onIdleFunc = func;
+        }
+
+        /**
+         * Return and reset given priority statistics
+         */
+        static inline Stats getStats(Priority priority)
+        {
+            logic state = isr::getState();
+            isr::disable();
+            Stats stats = _stats[priority];
+            isr::setState(state);
+            return stats;
+        }
+        static inline void resetStats(Priority priority)
+        {
+            logic state = isr::getState();
+            isr::disable();
+            _stats[priority] = {0, 0, 0, 0};
+            isr::setState(state);
+        }
+
+    private:
+
+        /**
+         * Queued work item with its
+         * data and post time in cycles
+         */
+        struct Item {
+            Work work;
+            word data;
+            uint32_t time;
+        };
+
+        /**
+         * Per priority ring buffers and
+         * head (producer) and tail (consumer) indexes
+         */
+        static volatile Item _queues[priorityCount][queueSize];
+        static volatile byte _heads[priorityCount];
+        static volatile byte _tails[priorityCount];
+
+        /**
+         * Per priority statistics
+         */
+        static Stats _stats[priorityCount];
+
+        /**
+         * Idle sleep mode and hook
+         */
+        static byte _sleepMode;
+        static logic _isSleep;
+        static Hook _onIdleFunc;
+};
+
+/**
+ * Non const member definition
+ */
+volatile EventLoop::Item EventLoop::_queues[EventLoop::priorityCount]
+    [EventLoop::queueSize];
+volatile byte EventLoop::_heads[EventLoop::priorityCount];
+volatile byte EventLoop::_tails[EventLoop::priorityCount];
+EventLoop::Stats EventLoop::_stats[EventLoop::priorityCount];
+byte EventLoop::_sleepMode = SLEEP_MODE_IDLE;
+logic EventLoop::_isSleep = True;
+EventLoop::Hook EventLoop::_onIdleFunc = nullptr;
+
+#endif
+
@@ -0,0 +1,311 @@
+#ifndef INPUTCAPTURE_HPP
+#define INPUTCAPTURE_HPP
+
+/**
+ * Use Timer1 input capture unit to
+ * timestamp edges on ICP1 pin (or Analog
+ * Comparator output) into a lock free ring buffer
+ *
+ * The 16 bits hardware captures are extended
+ * to 32 bits with Timer1 overflow counting.
+ * The capture interrupt only pushes the timestamp
+ * and the main loop pops them (single producer,
+ * single consumer, no critical section).
+ * Timer1 is owned by the capture engine
+ * (normal mode, free running).
+ */
+class InputCapture
+{
+    public:
+
+        /**
+         * Captured edges
+         * Both : edge selection is toggled after
+         * each capture (for pulse width and duty cycle)
+         */
+        enum Edge : byte {
+            EdgeRising,
+            EdgeFalling,
+            EdgeBoth,
+        };
+
+        /**
+         * Timestamped edge
+         * (time is in timer ticks)
+         */
+        struct Capture {
+            uint32_t time;
+            logic isRising;
+        };
+
+        /**
+         * Define capture ring buffer size
+         * (has to be a power of two)
+         */
+        static constexpr byte bufferSize = 32;
+        static_assert((bufferSize & (bufferSize-1)) == 0,
+            "InputCapture bufferSize has to be a power of two");
+
+        /**
+         * Configure Timer1 with given clock prescaler
+         * (internal clocks only), captured edges and
+         * noise canceler and start timestamping
+         */
+        static inline void start(timer::TimerClock clock,
+            Edge edge, logic isNoiseCanceler = False)
+        {
+            isr::disable();
+            timer::Timer1.setClock(timer::ClockStop);
+            timer::Timer1.setCounterMode(timer::WaveNormalTopNormal);
+            timer::Timer1.setPinModeA(timer::PinDisable);
+            timer::Timer1.setPinModeB(timer::PinDisable);
+            timer::Timer1.setCaptureNoiseCanceler(isNoiseCanceler);
+            if (edge == EdgeFalling) {
+                timer::Timer1.setCaptureEdge(timer::CaptureFalling);
+            } else {
+                timer::Timer1.setCaptureEdge(timer::CaptureRising);
+            }
+            timer::Timer1.writeCounter(0);
+            timer::Timer1.clearOverflow();
+            _isToggle = logic_cast((byte)(edge == EdgeBoth));
+            _overflow = 0;
+            _head = 0;
+            _tail = 0;
+            _lostCount = 0;
+            _tickRate = tickRate(clock);
+            timer::Timer1.onOverflow(InputCapture::isrOverflow);
+            timer::Timer1.onCapture(InputCapture::isrCapture);
+            isr::enable();
+            timer::Timer1.setClock(clock);
+        }
+
+        /**
+         * Stop timestamping
+         */
+        static inline void stop()
+        {
+            isr::disable();
+            timer::Timer1.setClock(timer::ClockStop);
+            timer::Timer1.onCapture();
+            timer::Timer1.onOverflow();
+            isr::enable();
+        }
+
+        /**
+         * Return the number of buffered captures
+         */
+        static inline byte available()
+        {
+            return (_head - _tail) & (bufferSize-1);
+        }
+
+        /**
+         * Pop the oldest capture into given one
+         * and return true or return false
+         * if the buffer is empty
+         */
+        static inline logic read(Capture& capture)
+        {
+            byte tail = _tail;
+            if (tail == _head) {
+                return False;
+            }
+            capture.time = _times[tail];
+            capture.isRising = _edges[tail];
+            _tail = (tail + 1) & (bufferSize-1);
+            return True;
+        }
+
+        /**
+         * Return the number of captures dropped
+         * because the buffer was full
+         */
+        static inline byte getLostCount()
+        {
+            return _lostCount;
+        }
+
+        /**
+         * Return the number of timer ticks per second
+         */
+        static inline uint32_t getTickRate()
+        {
+            return _tickRate;
+        }
+
+        /**
+         * Return the period in ticks
+         * between two timestamps
+         */
+        static inline uint32_t period(uint32_t first, uint32_t second)
+        {
+            return second - first;
+        }
+
+        /**
+         * Return the frequency in Hertz and the
+         * rotation speed in rotations per minute
+         * for given period in ticks
+         */
+        static inline uint32_t frequency(uint32_t period)
+        {
+            if (period == 0) {
+                return 0;
+            }
+            return _tickRate/period;
+        }
+        static inline uint32_t rpm(uint32_t period,
+            byte pulsesPerRotation = 1)
+        {
+            if (period == 0) {
+                return 0;
+            }
+            return (_tickRate*60)/(period*pulsesPerRotation);
+        }
+
+        /**
+         * Return the duty cycle in 1/10000 for
+         * given high time and period in ticks
+         */
+        static inline word dutyCycle(uint32_t high, uint32_t period)
+        {
+            while (period > 0xFFFF) {
+                period >>= 1;
+                high >>= 1;
+            }
+            if (period == 0) {
+                return 0;
+            }
+            return (high*10000)/period;
+        }
+
+        /**
+         * Pop captures until a rising, falling, rising
+         * sequence is found (EdgeBoth mode) and compute
+         * its period and high time in ticks. Out of
+         * sequence edges (lost captures) are skipped.
+         * Return false if not enough captures are buffered.
+         */
+        static inline logic readPulse(uint32_t& period, uint32_t& high)
+        {
+            Capture capture;
+            while (available() >= 3) {
+                byte tail = _tail;
+                byte second = (tail + 1) & (bufferSize-1);
+                byte third = (tail + 2) & (bufferSize-1);
+                if (
+                    !_edges[tail] ||
+                    _edges[second] == True ||
+                    !_edges[third]
+                ) {
+                    read(capture);
+                    continue;
+                }
+                read(capture);
+                uint32_t rise = capture.time;
+                read(capture);
+                uint32_t fall = capture.time;
+                high = fall - rise;
+                period = _times[third] - rise;
+                return True;
+            }
+            return False;
+        }
+
+        /**
+         * Timer1 input capture interrupt handler
+         */
+        static void isrCapture(HandlerArg(timer::Timer1) t)
+        {
+            word capture = t.readCapture();
+            word overflow = _overflow;
+            //Overflow pending while the capture
+            //occured just after the wrap
+            if (t.isOverflow() && capture < 0x8000) {
+                overflow++;
+            }
+            logic isRising = bits::get(*t.controlBReg, bits::Bit6);
+            if (_isToggle == True) {
+                bits::toggle(*t.controlBReg, bits::Bit6);
+                t.clearCapture();
+            }
+
+            byte head = _head;
+            byte next = (head + 1) & (bufferSize-1);
+            if (next == _tail) {
+                _lostCount++;
+                return;
+            }
+            _times[head] = ((uint32_t)overflow << 16) | capture;
+            _edges[head] = isRising;
+            _head = next;
+        }
+
+        /**
+         * Timer1 overflow interrupt handler
+         */
+        static void isrOverflow(HandlerArg(timer::Timer1) t)
+        {
+            _overflow++;
+        }
+
+    private:
+
+        /**
+         * Timestamp ring buffer and
+         * head (ISR) and tail (main) indexes
+         */
+        static volatile uint32_t _times[bufferSize];
+        static volatile logic _edges[bufferSize];
+        static volatile byte _head;
+        static volatile byte _tail;
+        static volatile byte _lostCount;
+
+        /**
+         * Timer1 overflow counter (high word
+         * of timestamps) and edge toggle mode
+         */
+        static volatile word _overflow;
+        static volatile logic _isToggle;
+
+        /**
+         * Timer ticks per second
+         */
+        static uint32_t _tickRate;
+
+        /**
+         * Return the tick rate of given
+         * internal clock prescaler
+         */
+        static inline uint32_t tickRate(timer::TimerClock clock)
+        {
+            if (clock == timer::ClockDiv1) {
+                return F_CPU;
+            } else if (clock == timer::ClockDiv8) {
+                return F_CPU/8;
+            } else if (clock == timer::ClockDiv64) {
+                return F_CPU/64;
+            } else if (clock == timer::ClockDiv256) {
+                return F_CPU/256;
+            } else if (clock == timer::ClockDiv1024) {
+                return F_CPU/1024;
+            } else {
+                return 0;
+            }
+        }
+};
+
+/**
+ * Non const member definition
+ */
+volatile uint32_t InputCapture::_times[InputCapture::bufferSize];
+volatile logic InputCapture::_edges[InputCapture::bufferSize];
+volatile byte InputCapture::_head = 0;
+volatile byte InputCapture::_tail = 0;
+volatile byte InputCapture::_lostCount = 0;
+volatile word InputCapture::_overflow = 0;
+volatile logic InputCapture::_isToggle = False;
+uint32_t InputCapture::_tickRate = 0;
+
+#endif
+
@@ -0,0 +1,317 @@
+#ifndef INTERNALMONITOR_HPP
+#define INTERNALMONITOR_HPP
+
+#include <avr/eeprom.h>
+
+/**
+ * Background supply voltage and internal
+ * temperature monitor using the Adc
+ *
+ * Supply voltage is measured against the 1.1V
+ * bandgap (with AVcc reference) and temperature
+ * with the internal sensor (with 1.1V reference).
+ * Conversions are chained from the Adc interrupt and
+ * the first conversions after each reference switch
+ * are discarded to let the reference settle.
+ * Results are given in millivolts and centi-degrees
+ * using integer only arithmetic and calibration
+ * constants stored in EEPROM.
+ * (The Adc is owned by the monitor while it is running)
+ */
+class InternalMonitor
+{
+    public:
+
+        /**
+         * Calibration constants
+         * Bandgap : actual bandgap voltage in millivolts
+         * Offset : sum of sampleCount temperature
+         * conversions at 25 degrees
+         * Gain : centi-degrees per conversion unit
+         * in 8.8 fixed point
+         */
+        struct Calibration {
+            word magic;
+            word bandgapMilliVolts;
+            word temperatureOffset;
+            word temperatureGain;
+        };
+
+        /**
+         * Number of discarded conversions after a reference
+         * switch (about 1.7ms with 128 prescaler) and number
+         * of accumulated conversions per measure
+         */
+        static constexpr byte settleCount = 16;
+        static constexpr byte sampleCount = 4;
+
+        /**
+         * Magic number of a valid stored calibration
+         */
+        static constexpr word calibrationMagic = 0xCA1B;
+
+        /**
+         * Load calibration from EEPROM (or datasheet
+         * typical values if none is stored) and
+         * start a first measure cycle
+         */
+        static inline void init(logic isContinuous = False)
+        {
+            loadCalibration();
+            start(isContinuous);
+        }
+
+        /**
+         * Start a background measure cycle (supply
+         * then temperature). If continuous, cycles are
+         * chained until stop() is called.
+         */
+        static inline void start(logic isContinuous = False)
+        {
+            isr::disable();
+            _isContinuous = isContinuous;
+            startVcc(adc::Adc);
+            adc::Adc.enable();
+            adc::Adc.setTrigger(adc::TriggerSingle);
+            adc::Adc.onConversionComplete(InternalMonitor::isrHandler);
+            adc::Adc.startConversion();
+            isr::enable();
+        }
+
+        /**
+         * Stop chained measure cycles
+         * after the current one
+         */
+        static inline void stop()
+        {
+            _isContinuous = False;
+        }
+
+        /**
+         * Return true if the supply voltage and
+         * temperature have been measured at least once
+         */
+        static inline logic isReady()
+        {
+            return _isReady;
+        }
+
+        /**
+         * Return true while a measure cycle
+         * is running
+         */
+        static inline logic isRunning()
+        {
+            return logic_cast((byte)(_phase != PhaseIdle));
+        }
+
+        /**
+         * Return last measured supply voltage
+         * in millivolts
+         */
+        static inline word getVccMilliVolts()
+        {
+            isr::disable();
+            word sum = _vccSum;
+            isr::enable();
+            if (sum == 0) {
+                return 0;
+            }
+            return ((uint32_t)_calibration.bandgapMilliVolts
+                *1024*sampleCount)/sum;
+        }
+
+        /**
+         * Return last measured internal temperature
+         * in centi-degrees Celsius
+         */
+        static inline sword getTemperatureCenti()
+        {
+            isr::disable();
+            word sum = _temperatureSum;
+            isr::enable();
+            int32_t delta = (int32_t)sum - _calibration.temperatureOffset;
+            return 2500 + ((delta*_calibration.temperatureGain)
+                >> (8 + log2SampleCount));
+        }
+
+        /**
+         * Adjust the bandgap calibration from given
+         * externally measured supply voltage in millivolts
+         * (A measure has to be available)
+         */
+        static inline void calibrateVcc(word actualMilliVolts)
+        {
+            isr::disable();
+            word sum = _vccSum;
+            isr::enable();
+            _calibration.bandgapMilliVolts =
+                ((uint32_t)actualMilliVolts*sum)/(1024*sampleCount);
+        }
+
+        /**
+         * Adjust the temperature offset from given
+         * externally measured temperature in centi-degrees
+         * (A measure has to be available)
+         */
+        static inline void calibrateTemperature(sword actualCenti)
+        {
+            isr::disable();
+            word sum = _temperatureSum;
+            isr::enable();
+            int32_t delta = ((int32_t)(actualCenti - 2500)
+                *(256*sampleCount))/_calibration.temperatureGain;
+            _calibration.temperatureOffset = sum - delta;
+        }
+
+        /**
+         * Read and write current calibration constants
+         */
+        static inline Calibration getCalibration()
+        {
+            return _calibration;
+        }
+        static inline void setCalibration(const Calibration& calibration)
+        {
+            _calibration = calibration;
+            _calibration.magic = calibrationMagic;
+        }
+
+        /**
+         * Load calibration constants from EEPROM
+         * Typical datasheet values are used if
+         * the EEPROM is not initialized
+         */
+        static inline void loadCalibration()
+        {
+            eeprom_read_block(&_calibration,
+                &_eepromCalibration, sizeof(Calibration));
+            if (_calibration.magic != calibrationMagic) {
+                _calibration.magic = calibrationMagic;
+                _calibration.bandgapMilliVolts = 1100;
+                _calibration.temperatureOffset = 292*sampleCount;
+                _calibration.temperatureGain = 25900;
+            }
+        }
+
+        /**
+         * Store current calibration constants in EEPROM
+         * (Only modified bytes are written)
+         */
+        static inline void saveCalibration()
+        {
+            eeprom_update_block(&_calibration,
+                &_eepromCalibration, sizeof(Calibration));
+        }
+
+        /**
+         * Adc conversion completed interrupt handler
+         */
+        static void isrHandler(HandlerArg(adc::Adc) a)
+        {
+            word value = a.readValue();
+            _count--;
+            if (_count >= sampleCount) {
+                //Settling, conversion discarded
+                a.startConversion();
+                return;
+            }
+            _sum += value;
+            if (_count != 0) {
+                a.startConversion();
+                return;
+            }
+
+            if (_phase == PhaseVcc) {
+                _vccSum = _sum;
+                _phase = PhaseTemperature;
+                _count = settleCount + sampleCount;
+                _sum = 0;
+                a.setReference(adc::ReferenceInternal);
+                a.setInput(adc::Temperature);
+                a.startConversion();
+            } else {
+                _temperatureSum = _sum;
+                _isReady = True;
+                if (_isContinuous == True) {
+                    startVcc(a);
+                    a.startConversion();
+                } else {
+                    _phase = PhaseIdle;
+                    a.onConversionComplete();
+                }
+            }
+        }
+
+    private:
+
+        /**
+         * Measure cycle phase
+         */
+        enum Phase : byte {
+            PhaseIdle,
+            PhaseVcc,
+            PhaseTemperature,
+        };
+
+        /**
+         * Sample count as shift
+         */
+        static constexpr byte log2SampleCount = 2;
+        static_assert((1 << log2SampleCount) == sampleCount,
+            "sampleCount has to be 2^log2SampleCount");
+
+        /**
+         * Current phase, remaining conversions
+         * and accumulated conversions
+         */
+        static volatile Phase _phase;
+        static volatile byte _count;
+        static volatile word _sum;
+        static volatile logic _isContinuous;
+
+        /**
+         * Last supply and temperature
+         * accumulated conversions
+         */
+        static volatile word _vccSum;
+        static volatile word _temperatureSum;
+        static volatile logic _isReady;
+
+        /**
+         * Current and EEPROM stored
+         * calibration constants
+         */
+        static Calibration _calibration;
+        static Calibration _eepromCalibration;
+
+        /**
+         * Switch the Adc to bandgap measure
+         * against supply reference
+         */
+        static inline void startVcc(HandlerArg(adc::Adc) a)
+        {
+            _phase = PhaseVcc;
+            _count = settleCount + sampleCount;
+            _sum = 0;
+            a.setReference(adc::ReferenceSupply);
+            a.setInput(adc::Internal);
+        }
+};
+
+/**
+ * Non const member definition
+ */
+volatile InternalMonitor::Phase InternalMonitor::_phase =
+    InternalMonitor::PhaseIdle;
+volatile byte InternalMonitor::_count = 0;
+volatile word InternalMonitor::_sum = 0;
+volatile logic InternalMonitor::_isContinuous = False;
+volatile word InternalMonitor::_vccSum = 0;
+volatile word InternalMonitor::_temperatureSum = 0;
+volatile logic InternalMonitor::_isReady = False;
+InternalMonitor::Calibration InternalMonitor::_calibration;
+InternalMonitor::Calibration InternalMonitor::_eepromCalibration EEMEM;
+
+#endif
+
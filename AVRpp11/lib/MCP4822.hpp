@@ -1,6 +1,8 @@
 #ifndef MCP4822_HPP
 #define MCP4822_HPP
 
+#include "Coroutine.hpp"
+
 /**
  * MCP4822 Digital to Analogic Converter
  * using SPI serial interface
@@ -17,6 +19,38 @@ class MCP4822
             ChannelB,
         };
 
+        /**
+         * Frame transmission mode
+         * Interrupt : one Spi interrupt per byte, the
+         * call returns immediately and the DAC is
+         * latched at the next write call
+         * Polled : the call waits for each byte (16 cycles
+         * at ClockDiv2) and latches the DAC before returning
+         * (about 60 cycles for one channel and 110 cycles for
+         * both channels instead of 4 or 8 Spi interrupts)
+         */
+        enum TransferMode : uint8_t {
+            TransferInterrupt,
+            TransferPolled,
+        };
+
+        /**
+         * Streamed output channels
+         */
+        enum StreamMode : uint8_t {
+            StreamChannelA,
+            StreamChannelB,
+            StreamBoth,
+        };
+
+        /**
+         * Define stream ring buffer size in samples
+         * (has to be a power of two)
+         */
+        static constexpr byte streamSize = 64;
+        static_assert((streamSize & (streamSize-1)) == 0,
+            "MCP4822 streamSize has to be a power of two");
+
         /**
          * Initialize Spi for DAC transmission
          * The latch Gpio Pin is given 
@@ -43,24 +77,22 @@ class MCP4822
 
         /**
          * Start the write of given 12 bits value in DAC given 
-         * output register (A or B)
+         * output register (A or B) with given transfer mode
          * The data transmission is stopped when completed
          * and DAC is latched
          * (Do not request a new write until last 
          * transmission isn't completed)
          */
-        static inline void writeChannel(Channel channel, word value)
+        static inline void writeChannel(Channel channel, word value,
+            TransferMode mode = TransferInterrupt)
         {
             //Latch previous sent data
-            _latchPin->write(Low);
-            __asm__ __volatile__ ("nop\n\t");
-            __asm__ __volatile__ ("nop\n\t");
-            _latchPin->write(High);
+            latch();
 
             spi::Spi.onTransfertComplet();
             _frame1H = 0;
             _frame1L = 0;
-            _state = 0;
+            _transfer.frameCount = 1;
 
             //Output channel
             if (channel == ChannelA) {
@@ -76,34 +108,38 @@ class MCP4822
             _frame1H |= (value >> 8) & 0b00001111;
             _frame1L = value & 0b11111111;
 
+            if (mode == TransferPolled) {
+                sendPolled(_frame1H, _frame1L);
+                latch();
+                return;
+            }
+
             //Start transmision
-            spi::Spi.onTransfertComplet(MCP4822::isrHanderOneChannel);
-            gpio::SS.write(Low);
-            spi::Spi.write(_frame1H);
+            _transfer.start();
+            spi::Spi.onTransfertComplet(MCP4822::isrHandler);
+            _transfer.resume();
         }
         
         /**
          * Start the write of given 12 bits value in DAC 
-         * both A and B output channel
+         * both A and B output channel with given transfer mode
          * The data transmission is stopped when completed
          * and DAC is latched
          * (Do not request a new write until last 
          * transmission isn't completed)
          */
-        static inline void writeBoth(word channelA, word channelB)
+        static inline void writeBoth(word channelA, word channelB,
+            TransferMode mode = TransferInterrupt)
         {
             //Latch previous sent data
-            _latchPin->write(Low);
-            __asm__ __volatile__ ("nop\n\t");
-            __asm__ __volatile__ ("nop\n\t");
-            _latchPin->write(High);
+            latch();
 
             spi::Spi.onTransfertComplet();
             _frame1H = 0;
             _frame1L = 0;
             _frame2H = 0;
             _frame2L = 0;
-            _state = 0;
+            _transfer.frameCount = 2;
 
             //Output channel
             bits::add(_frame1H, ~bits::Bit7);
@@ -120,51 +156,214 @@ class MCP4822
             _frame2H |= (channelB >> 8) & 0b00001111;
             _frame2L = channelB & 0b11111111;
 
+            if (mode == TransferPolled) {
+                sendPolled(_frame1H, _frame1L);
+                sendPolled(_frame2H, _frame2L);
+                latch();
+                return;
+            }
+
             //Start transmision
-            spi::Spi.onTransfertComplet(MCP4822::isrHanderBothChannel);
-            gpio::SS.write(Low);
-            spi::Spi.write(_frame1H);
+            _transfer.start();
+            spi::Spi.onTransfertComplet(MCP4822::isrHandler);
+            _transfer.resume();
         }
 
         /**
-         * Spi on byte transmission completed interrupt handler
-         * for one channel tranmission
+         * Start streaming buffered samples at given
+         * sample rate in Hertz on given channels.
+         * Timer1 (owned while streaming) generates the
+         * LDAC low pulse on OC1A in hardware at each
+         * period start, so the latch pin given to init()
+         * has to be OC1A. The compare A interrupt then
+         * sends the next sample, latched at next period.
+         * At 16MHz, up to about 140kHz on one channel and
+         * 85kHz on both channels can be sustained.
+         * Return the actual sample rate (zero if given
+         * rate can not be reached).
          */
-        static void isrHanderOneChannel(HandlerArg(spi::Spi) s)
+        static inline uint32_t startStream(uint32_t frequency,
+            StreamMode mode)
         {
-            if (_state == 0) {
-                _state = 1;
-                spi::Spi.write(_frame1L);
-            } else if (_state == 1) {
-                gpio::SS.write(High);
-                spi::Spi.onTransfertComplet();
+            if (frequency == 0) {
+                return 0;
             }
+            timer::TimerSetting setting = timer::solveTimer(
+                timer::cyclesFromFrequency(frequency),
+                timer::Width16Bits, timer::PrescalersTimer01);
+            if (setting.clock == timer::ClockStop || setting.top < 2) {
+                return 0;
+            }
+
+            isr::disable();
+            spi::Spi.onTransfertComplet();
+            _streamMode = mode;
+            _streamHead = 0;
+            _streamTail = 0;
+            _underrunCount = 0;
+            timer::Timer1.setClock(timer::ClockStop);
+            timer::Timer1.setCounterMode(timer::WavePwmTopCapture);
+            timer::Timer1.setPinModeB(timer::PinDisable);
+            //Low pulse from BOTTOM to compare A (two ticks)
+            timer::Timer1.writeCapture(setting.top);
+            timer::Timer1.writeCompareA(1);
+            timer::Timer1.writeCounter(0);
+            timer::Timer1.setPinModeA(timer::PinPwmInv);
+            gpio::OC1A.setMode(gpio::Output);
+            timer::Timer1.clearMatchA();
+            timer::Timer1.onMatchA(MCP4822::isrStream);
+            isr::enable();
+            timer::Timer1.setClock(setting.clock);
+
+            return F_CPU/setting.cycles;
+        }
+
+        /**
+         * Stop streaming
+         * (last latched value is kept)
+         */
+        static inline void stopStream()
+        {
+            isr::disable();
+            timer::Timer1.setClock(timer::ClockStop);
+            timer::Timer1.onMatchA();
+            timer::Timer1.setPinModeA(timer::PinDisable);
+            _latchPin->write(High);
+            isr::enable();
+        }
+
+        /**
+         * Queue given 12 bits sample (single channel)
+         * or samples pair (both channels) and return true
+         * or return false if the buffer is full
+         */
+        static inline logic push(word value)
+        {
+            byte head = _streamHead;
+            byte next = (head + 1) & (streamSize-1);
+            if (next == _streamTail) {
+                return False;
+            }
+            _streamSamples[head] = value;
+            _streamHead = next;
+            return True;
+        }
+        static inline logic push(word channelA, word channelB)
+        {
+            byte head = _streamHead;
+            byte next = (head + 2) & (streamSize-1);
+            if (next == _streamTail || 
+                ((head + 1) & (streamSize-1)) == _streamTail
+            ) {
+                return False;
+            }
+            _streamSamples[head] = channelA;
+            _streamSamples[head + 1] = channelB;
+            _streamHead = next;
+            return True;
+        }
+
+        /**
+         * Return the number of free samples
+         * in the stream buffer
+         */
+        static inline byte getStreamFree()
+        {
+            return (_streamTail - _streamHead - 1) & (streamSize-1);
+        }
+
+        /**
+         * Return the number of periods without
+         * buffered sample since stream start
+         * (the previous value is latched again)
+         */
+        static inline word getUnderrunCount()
+        {
+            isr::disable();
+            word count = _underrunCount;
+            isr::enable();
+            return count;
+        }
+
+        /**
+         * Timer1 compare A interrupt handler
+         * (LDAC pulse just ended, send next sample)
+         * The two bytes transmission (16 cycles each
+         * at ClockDiv2) is polled, faster than the Spi
+         * interrupt round trip.
+         */
+        static void isrStream(HandlerArg(timer::Timer1) t)
+        {
+            byte tail = _streamTail;
+            if (tail == _streamHead) {
+                _underrunCount++;
+                return;
+            }
+            if (_streamMode == StreamBoth) {
+                sendBoth(_streamSamples[tail], _streamSamples[tail + 1]);
+                _streamTail = (tail + 2) & (streamSize-1);
+            } else {
+                word value = _streamSamples[tail];
+                byte header = _streamMode == StreamChannelA ? 
+                    0b00010000 : 0b10010000;
+                sendPolled(header | ((value >> 8) & 0b00001111),
+                    value & 0b11111111);
+                _streamTail = (tail + 1) & (streamSize-1);
+            }
+        }
+
+        /**
+         * Send both channels 12 bits samples with
+         * polled Spi without latching them (for stream
+         * interrupt handlers, the LDAC pulse is generated
+         * by Timer1, Spi interrupt has to be disabled)
+         */
+        static inline void sendBoth(word channelA, word channelB)
+        {
+            sendPolled(0b00010000 | ((channelA >> 8) & 0b00001111),
+                channelA & 0b11111111);
+            sendPolled(0b10010000 | ((channelB >> 8) & 0b00001111),
+                channelB & 0b11111111);
         }
 
         /**
          * Spi on byte transmission completed interrupt handler
-         * for both channel tranmission
+         * (resume the transmission)
          */
-        static void isrHanderBothChannel(HandlerArg(spi::Spi) s)
+        static void isrHandler(HandlerArg(spi::Spi) s)
         {
-            if (_state == 0) {
-                _state = 1;
-                spi::Spi.write(_frame1L);
-            } else if (_state == 1) {
-                _state = 2;
-                gpio::SS.write(High);
+            _transfer.resume();
+        }
+
+    private:
+
+        /**
+         * Transmission of one or two 16 bits frames,
+         * one step per Spi transmission completed
+         */
+        struct Transfer : public Coroutine {
+            byte frameCount;
+            inline void resume()
+            {
+                CO_BEGIN();
                 gpio::SS.write(Low);
-                spi::Spi.write(_frame2H);
-            } else if (_state == 2) {
-                _state = 3;
-                spi::Spi.write(_frame2L);
-            } else if (_state == 3) {
+                spi::Spi.write(_frame1H);
+                CO_YIELD();
+                spi::Spi.write(_frame1L);
+                CO_YIELD();
                 gpio::SS.write(High);
+                if (frameCount == 2) {
+                    gpio::SS.write(Low);
+                    spi::Spi.write(_frame2H);
+                    CO_YIELD();
+                    spi::Spi.write(_frame2L);
+                    CO_YIELD();
+                    gpio::SS.write(High);
+                }
                 spi::Spi.onTransfertComplet();
+                CO_END();
             }
-        }
-
-    private:
+        };
 
         /**
          * Transmission state and data
@@ -173,8 +372,47 @@ class MCP4822
         static volatile byte _frame1L;
         static volatile byte _frame2H;
         static volatile byte _frame2L;
-        static volatile byte _state;
+        static Transfer _transfer;
         static const gpio::GpioObject* _latchPin;
+
+        /**
+         * Stream ring buffer, head (main) and
+         * tail (interrupt) indexes, mode and
+         * underrun counter
+         */
+        static volatile word _streamSamples[streamSize];
+        static volatile byte _streamHead;
+        static volatile byte _streamTail;
+        static StreamMode _streamMode;
+        static volatile word _underrunCount;
+
+        /**
+         * Send a 16 bits frame with given high
+         * and low bytes waiting for each
+         * byte transmission
+         * (Spi interrupt has to be disabled)
+         */
+        static inline void sendPolled(byte high, byte low)
+        {
+            gpio::SS.write(Low);
+            spi::Spi.write(high);
+            while (!spi::Spi.isTransfertComplet());
+            spi::Spi.write(low);
+            while (!spi::Spi.isTransfertComplet());
+            gpio::SS.write(High);
+        }
+
+        /**
+         * Pulse the latch pin to transfer
+         * sent data to DAC outputs
+         */
+        static inline void latch()
+        {
+            _latchPin->write(Low);
+            __asm__ __volatile__ ("nop\n\t");
+            __asm__ __volatile__ ("nop\n\t");
+            _latchPin->write(High);
+        }
 };
 
 /**
@@ -184,8 +422,13 @@ volatile byte MCP4822::_frame1H;
 volatile byte MCP4822::_frame1L;
 volatile byte MCP4822::_frame2H;
 volatile byte MCP4822::_frame2L;
-volatile byte MCP4822::_state;
+MCP4822::Transfer MCP4822::_transfer;
 const gpio::GpioObject* MCP4822::_latchPin = nullptr;
+volatile word MCP4822::_streamSamples[MCP4822::streamSize];
+volatile byte MCP4822::_streamHead = 0;
+volatile byte MCP4822::_streamTail = 0;
+MCP4822::StreamMode MCP4822::_streamMode = MCP4822::StreamChannelA;
+volatile word MCP4822::_underrunCount = 0;
 
 #endif
 
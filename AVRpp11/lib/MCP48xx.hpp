@@ -0,0 +1,221 @@
+#ifndef MCP48XX_HPP
+#define MCP48XX_HPP
+
+/**
+ * MCP4802/4812/4822 dual Digital to Analogic
+ * Converter family on SPI serial interface
+ *
+ * Each instance has its own chip select and latch
+ * (LDAC) pins, channels gain and shutdown state.
+ * Frames are sent with polled Spi (16 cycles per byte
+ * at ClockDiv2). Several DACs sharing the same latch pin
+ * are updated simultaneously by a single latch() after
+ * all their frames are sent. Without latch pin (LDAC tied
+ * low), outputs are updated at the end of each frame.
+ * (Do not mix with MCP4822 interrupt transfers or
+ * streaming on the same Spi bus)
+ *
+ * MCP4812 dac(gpio::D7, gpio::D8);
+ * dac.init();
+ * dac.setGain(dac.ChannelA, dac.Gain1x);
+ * dac.write(dac.ChannelA, 512);
+ * dac.latch();
+ */
+template <byte Bits>
+class MCP48xx
+{
+    static_assert(Bits == 8 || Bits == 10 || Bits == 12,
+        "MCP48xx resolution has to be 8, 10 or 12 bits");
+
+    public:
+
+        /**
+         * DAC output channel
+         */
+        enum Channel : byte {
+            ChannelA,
+            ChannelB,
+        };
+
+        /**
+         * Output gain
+         * (full scale is 2.048V or 4.096V)
+         */
+        enum Gain : byte {
+            Gain1x,
+            Gain2x,
+        };
+
+        /**
+         * Maximum channel value
+         */
+        static constexpr word maxValue = (1 << Bits) - 1;
+
+        /**
+         * Create a DAC with given chip select pin and
+         * latch pin (nullptr if LDAC is tied low)
+         * (Pins must not be used by Spi MOSI/MISO/SCK)
+         */
+        MCP48xx(const gpio::GpioObject& csPin,
+            const gpio::GpioObject* latchPin = nullptr) :
+            _csPin(csPin),
+            _latchPin(latchPin),
+            _config{configGain1x | configActive,
+                configGain1x | configActive},
+            _values{0, 0}
+        {
+        }
+        MCP48xx(const gpio::GpioObject& csPin,
+            const gpio::GpioObject& latchPin) :
+            MCP48xx(csPin, &latchPin)
+        {
+        }
+
+        /**
+         * Initialize Spi as master and the
+         * chip select and latch pins
+         * (Gain is 1x and channels are active)
+         */
+        inline void init() const
+        {
+            isr::disable();
+            spi::Spi.setMode(spi::Master);
+            spi::Spi.setBitOrder(spi::MSBFirst);
+            spi::Spi.setClockIdle(spi::ClockHigh);
+            spi::Spi.setClockEdge(spi::ClockTrailing);
+            spi::Spi.setClockDivider(spi::ClockDiv2);
+            spi::Spi.onTransfertComplet();
+            isr::enable();
+
+            //SS has to stay output for Spi master mode
+            gpio::SS.setMode(gpio::Output);
+            _csPin.write(High);
+            _csPin.setMode(gpio::Output);
+            if (_latchPin != nullptr) {
+                _latchPin->write(High);
+                _latchPin->setMode(gpio::Output);
+            }
+        }
+
+        /**
+         * Set given channel gain
+         * (applied at next write)
+         */
+        inline void setGain(Channel channel, Gain gain)
+        {
+            if (gain == Gain2x) {
+                _config[channel] &= ~configGain1x;
+            } else {
+                _config[channel] |= configGain1x;
+            }
+        }
+
+        /**
+         * Shutdown given channel (output is high
+         * impedance and supply current drops) or
+         * enable it again with its last value.
+         * The frame is sent immediately.
+         */
+        inline void shutdown(Channel channel)
+        {
+            _config[channel] &= ~configActive;
+            send(channel);
+        }
+        inline void enable(Channel channel)
+        {
+            _config[channel] |= configActive;
+            send(channel);
+        }
+
+        /**
+         * Return true if given channel is not shutdown
+         */
+        inline logic isEnabled(Channel channel) const
+        {
+            return logic_cast((byte)(_config[channel] & configActive));
+        }
+
+        /**
+         * Send given value (0 to maxValue) to given
+         * channel input register or both channels.
+         * Outputs are updated at next latch() (or at
+         * the end of the frame without latch pin).
+         */
+        inline void write(Channel channel, word value)
+        {
+            _values[channel] = value;
+            send(channel);
+        }
+        inline void write(word channelA, word channelB)
+        {
+            _values[ChannelA] = channelA;
+            _values[ChannelB] = channelB;
+            send(ChannelA);
+            send(ChannelB);
+        }
+
+        /**
+         * Pulse the latch pin, updating the outputs
+         * of every DAC sharing this latch pin
+         */
+        inline void latch() const
+        {
+            if (_latchPin != nullptr) {
+                _latchPin->write(Low);
+                __asm__ __volatile__ ("nop\n\t");
+                __asm__ __volatile__ ("nop\n\t");
+                _latchPin->write(High);
+            }
+        }
+
+    private:
+
+        /**
+         * Frame high byte configuration bits
+         * (gain select and shutdown)
+         */
+        static constexpr byte configGain1x = 0b00100000;
+        static constexpr byte configActive = 0b00010000;
+
+        /**
+         * Chip select and latch pins
+         */
+        const gpio::GpioObject& _csPin;
+        const gpio::GpioObject* _latchPin;
+
+        /**
+         * Channels configuration bits and value
+         */
+        byte _config[2];
+        word _values[2];
+
+        /**
+         * Send given channel frame
+         * waiting for each byte transmission
+         */
+        inline void send(Channel channel) const
+        {
+            word data = _values[channel] << (12 - Bits);
+            byte high = _config[channel] | ((data >> 8) & 0b00001111);
+            if (channel == ChannelB) {
+                high |= 0b10000000;
+            }
+            _csPin.write(Low);
+            spi::Spi.write(high);
+            while (!spi::Spi.isTransfertComplet());
+            spi::Spi.write(data & 0b11111111);
+            while (!spi::Spi.isTransfertComplet());
+            _csPin.write(High);
+        }
+};
+
+/**
+ * Family members
+ * (12 bits MCP4822 is MCP48xx<12>, the
+ * MCP4822 name is the single DAC static driver)
+ */
+typedef MCP48xx<8> MCP4802;
+typedef MCP48xx<10> MCP4812;
+
+#endif
+
@@ -0,0 +1,334 @@
+#ifndef MEMORYMONITOR_HPP
+#define MEMORYMONITOR_HPP
+
+#include "Printer.hpp"
+#ifdef AVRPP11_MEMORYMONITOR_TIMER
+#include "SoftTimer.hpp"
+#endif
+
+/**
+ * Linker defined memory section bounds
+ * and malloc heap break (nullptr while
+ * nothing is allocated)
+ * (emulated SRAM symbols on host)
+ */
+#ifndef AVRPP11_HOST
+extern "C" {
+    extern byte __data_start;
+    extern byte __data_end;
+    extern byte __bss_start;
+    extern byte __bss_end;
+    extern byte __heap_start;
+    extern byte* __brkval;
+}
+#else
+using host::__data_start;
+using host::__data_end;
+using host::__bss_start;
+using host::__bss_end;
+using host::__heap_start;
+using host::__brkval;
+#endif
+
+/**
+ * SRAM usage and stack high water mark monitor
+ *
+ * The free memory between the end of .bss and
+ * the top of the stack is painted with a canary
+ * byte at reset (from the .init1 section, before
+ * .data and .bss initialization). Memory never
+ * touched by the stack still holds the canary, so the
+ * stack high water mark is found by scanning upward
+ * from the heap break (a stack byte equal to the canary
+ * may underestimate it by a few bytes).
+ * check() is meant to be called periodically (main
+ * loop, or a SoftTimer with startPeriodicCheck() when
+ * AVRPP11_MEMORYMONITOR_TIMER is defined) and calls the
+ * fault hook when the stack has reached the guard zone
+ * above the heap, before it corrupts the heap or .bss.
+ * Memory released by free() below the last seen heap
+ * break is painted again by check() and getUsage().
+ * A heap growing and shrinking back between two calls
+ * leaves its old data above the break, which is reported
+ * as stack use (and as fault within the guard zone).
+ *
+ * MemoryMonitor::onFault(fault);
+ * ...
+ * MemoryMonitor::check();
+ */
+class MemoryMonitor
+{
+    public:
+
+        /**
+         * Fault hook called with the
+         * remaining stack free bytes
+         */
+        typedef void (*Hook)(word freeSize);
+
+        /**
+         * Canary byte and guard zone size in bytes
+         * above the heap break checked by check()
+         */
+        static constexpr byte canary = 0xC5;
+        static constexpr byte guardSize = 32;
+
+        /**
+         * Memory usage in bytes
+         * dataSize, bssSize : static variables
+         * heapSize : malloc heap up to the break
+         * stackSize : current stack depth
+         * stackMaxSize : stack high water mark
+         * freeSize : current free memory between
+         * the heap break and the stack pointer
+         * unusedSize : memory never touched by
+         * the stack above the heap break
+         */
+        struct Usage {
+            word dataSize;
+            word bssSize;
+            word heapSize;
+            word stackSize;
+            word stackMaxSize;
+            word freeSize;
+            word unusedSize;
+        };
+
+        /**
+         * Return the lowest address and
+         * the end of .data, .bss and the heap
+         */
+        static inline word getDataStart()
+        {
+            return address(&__data_start);
+        }
+        static inline word getDataEnd()
+        {
+            return address(&__data_end);
+        }
+        static inline word getBssStart()
+        {
+            return address(&__bss_start);
+        }
+        static inline word getBssEnd()
+        {
+            return address(&__bss_end);
+        }
+        static inline word getHeapStart()
+        {
+            return address(&__heap_start);
+        }
+        static inline word getHeapEnd()
+        {
+            return __brkval == nullptr ?
+                address(&__heap_start) : address(__brkval);
+        }
+
+        /**
+         * Return current free memory between
+         * the heap break and the stack pointer
+         */
+        static inline word getFreeSize()
+        {
+            return SP - getHeapEnd();
+        }
+
+        /**
+         * Return the lowest address ever reached by
+         * the stack (scan of the painted memory)
+         */
+        static inline word getStackLowest()
+        {
+            const byte* current = pointer(updateHeapEnd());
+            const byte* end = pointer(SP + 1);
+            while (current < end && *current == canary) {
+                current++;
+            }
+            return address(current);
+        }
+
+        /**
+         * Return all memory usage
+         * (scans the painted memory)
+         */
+        static inline Usage getUsage()
+        {
+            Usage usage;
+            word heapEnd = getHeapEnd();
+            word stackPointer = SP;
+            word lowest = getStackLowest();
+            usage.dataSize = getDataEnd() - getDataStart();
+            usage.bssSize = getBssEnd() - getBssStart();
+            usage.heapSize = heapEnd - getHeapStart();
+            usage.stackSize = RAMEND - stackPointer;
+            usage.stackMaxSize = RAMEND - lowest + 1;
+            usage.freeSize = stackPointer - heapEnd;
+            usage.unusedSize = lowest - heapEnd;
+            return usage;
+        }
+
+        /**
+         * Set the fault hook
+         * (nullptr to remove)
+         */
+        static inline void onFault(Hook func = nullptr)
+        {
+            _onFaultFunc = func;
+        }
+
+        /**
+         * Check that the stack has not reached the
+         * guard zone above the heap break and call the
+         * fault hook otherwise (about 10 cycles per guard
+         * byte). Return false on fault.
+         */
+        static inline logic check()
+        {
+            word heapEnd = updateHeapEnd();
+            word freeSize = SP - heapEnd;
+            logic isFault = logic_cast((byte)(freeSize <= guardSize));
+            const byte* guard = pointer(heapEnd);
+            for (byte i=0;i<guardSize && !isFault;i++) {
+                if (guard[i] != canary) {
+                    isFault = True;
+                }
+            }
+            if (isFault == True && _onFaultFunc != nullptr) {
+                _onFaultFunc(freeSize);
+            }
+            return !isFault;
+        }
+
+#ifdef AVRPP11_MEMORYMONITOR_TIMER
+        /**
+         * Call check() every given period in cpu
+         * cycles from a SoftTimer in given context.
+         * Return the timer id (to be stopped with
+         * SoftTimer::stop) or None if no timer is available.
+         */
+        static inline byte startPeriodicCheck(uint32_t period,
+            SoftTimer::Context context = SoftTimer::ContextIsr)
+        {
+            return SoftTimer::start(MemoryMonitor::timerCheck,
+                period, period, context);
+        }
+#endif
+
+        /**
+         * Print memory usage with Printer
+         */
+        static inline void report()
+        {
+            Usage usage = getUsage();
+            Printer::write("data bss heap stack stackMax free unused");
+            Printer::endl();
+            Printer::write(usage.dataSize);
+            Printer::write(' ');
+            Printer::write(usage.bssSize);
+            Printer::write(' ');
+            Printer::write(usage.heapSize);
+            Printer::write(' ');
+            Printer::write(usage.stackSize);
+            Printer::write(' ');
+            Printer::write(usage.stackMaxSize);
+            Printer::write(' ');
+            Printer::write(usage.freeSize);
+            Printer::write(' ');
+            Printer::write(usage.unusedSize);
+            Printer::endl();
+        }
+
+    private:
+
+        /**
+         * Fault hook and last seen heap break
+         */
+        static Hook _onFaultFunc;
+        static word _heapEnd;
+
+        /**
+         * Return the heap break after painting
+         * again the memory released since the last
+         * call (up to the stack pointer)
+         */
+        static inline word updateHeapEnd()
+        {
+            logic state = isr::getState();
+            isr::disable();
+            word heapEnd = getHeapEnd();
+            word released = _heapEnd < SP ? _heapEnd : SP;
+            for (word i=heapEnd;i<released;i++) {
+                *pointer(i) = canary;
+            }
+            _heapEnd = heapEnd;
+            isr::setState(state);
+            return heapEnd;
+        }
+
+#ifdef AVRPP11_MEMORYMONITOR_TIMER
+        /**
+         * SoftTimer periodic check callback
+         */
+        static void timerCheck()
+        {
+            check();
+        }
+#endif
+
+        /**
+         * Convert between data space
+         * addresses and pointers
+         */
+        static inline word address(const byte* data)
+        {
+#ifdef AVRPP11_HOST
+            return data - host::sram;
+#else
+            return (word)(uintptr_t)data;
+#endif
+        }
+        static inline byte* pointer(word value)
+        {
+#ifdef AVRPP11_HOST
+            return &host::sram[value];
+#else
+            return (byte*)(uintptr_t)value;
+#endif
+        }
+
+        /**
+         * Paint the memory from the end of
+         * .bss to the top of the stack at reset
+         * (no stack and no r1 zero yet)
+         */
+#ifndef AVRPP11_HOST
+        static void paint()
+            __attribute__((naked, used, section(".init1")));
+#endif
+};
+
+/**
+ * Non const member definition
+ */
+MemoryMonitor::Hook MemoryMonitor::_onFaultFunc = nullptr;
+word MemoryMonitor::_heapEnd = 0;
+#ifndef AVRPP11_HOST
+void MemoryMonitor::paint()
+{
+    __asm__ __volatile__ (
+        "ldi r30, lo8(_end)\n\t"
+        "ldi r31, hi8(_end)\n\t"
+        "ldi r24, %0\n\t"
+        "ldi r25, hi8(__stack)\n\t"
+        "1:\n\t"
+        "st Z+, r24\n\t"
+        "cpi r30, lo8(__stack)\n\t"
+        "cpc r31, r25\n\t"
+        "brlo 1b\n\t"
+        :
+        : "i" (canary)
+        : "r24", "r25", "r30", "r31", "memory");
+}
+#endif
+
+#endif
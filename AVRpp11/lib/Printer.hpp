@@ -1,6 +1,8 @@
 #ifndef PRINTER_HPP
 #define PRINTER_HPP
 
+#include <avr/pgmspace.h>
+
 /**
  * Macros for number to string conversion
  */
@@ -138,6 +140,33 @@ class Printer
             write(str);
         }
 
+        /**
+         * Print given 32 bits unsigned number
+         */
+        static inline void write(uint32_t val)
+        {
+            static const uint32_t powers[10] PROGMEM = {
+                1000000000UL, 100000000UL, 10000000UL, 1000000UL,
+                100000UL, 10000UL, 1000UL, 100UL, 10UL, 1UL};
+            char str[11];
+            byte index = 0;
+            for (byte i=0;i<10;i++) {
+                uint32_t power = pgm_read_dword(&powers[i]);
+                char digit = '0';
+                while (val >= power) {
+                    val -= power;
+                    digit++;
+                }
+                if (digit != '0' || index > 0 || i == 9) {
+                    str[index] = digit;
+                    index++;
+                }
+            }
+            str[index] = '\0';
+
+            write(str);
+        }
+
         /**
          * Print given logical value
          */
@@ -172,6 +201,17 @@ class Printer
             }
         }
 
+#ifdef AVRPP11_HOST
+        /**
+         * Host int is 32 bits
+         * (sword on target)
+         */
+        static inline void write(int val)
+        {
+            write((sword)val);
+        }
+#endif
+
         /**
          * Compilator time alias
          */
@@ -0,0 +1,231 @@
+#ifndef PROFILER_HPP
+#define PROFILER_HPP
+
+#include "SystemClock.hpp"
+#include "Printer.hpp"
+
+/**
+ * Cycle accurate profiling zones
+ * on SystemClock timebase
+ *
+ * A zone is identified by a number (user enum)
+ * and optionally named. Each scope measures the cpu
+ * cycles between its construction and destruction and
+ * accumulates count, min, max and total cycles of its
+ * zone. The measurement overhead (two SystemClock reads)
+ * is calibrated by init() and subtracted. Zones can be
+ * nested (the outer zone includes the inner overhead)
+ * and used in interrupt handlers.
+ * SystemClock has to be initialized first.
+ *
+ * void loop() {
+ *     PROFILE_ZONE(ZoneLoop);
+ *     ...
+ * }
+ */
+class Profiler
+{
+    public:
+
+        /**
+         * Define the number of zones
+         */
+        static constexpr byte zoneCount = 16;
+
+        /**
+         * Zone statistics in cpu cycles
+         * (total saturates at 2^32-1 cycles,
+         * 268s at 16MHz, reset the zone before)
+         */
+        struct Stats {
+            uint32_t count;
+            uint32_t min;
+            uint32_t max;
+            uint32_t total;
+        };
+
+        /**
+         * Measure the enclosing scope
+         * in given zone
+         */
+        class Scope
+        {
+            public:
+
+                inline Scope(byte zone) :
+                    _zone(zone),
+                    _start(SystemClock::cycles())
+                {
+                }
+                inline ~Scope()
+                {
+                    Profiler::add(_zone, SystemClock::cycles() - _start);
+                }
+
+            private:
+
+                const byte _zone;
+                const uint32_t _start;
+        };
+
+        /**
+         * Reset all zones and calibrate
+         * the measurement overhead
+         */
+        static inline void init()
+        {
+            resetAll();
+            //Keep the smallest empty measure
+            //(not interrupted)
+            _overhead = 0xFFFFFFFF;
+            for (byte i=0;i<16;i++) {
+                uint32_t start = SystemClock::cycles();
+                uint32_t cycles = SystemClock::cycles() - start;
+                if (cycles < _overhead) {
+                    _overhead = cycles;
+                }
+            }
+        }
+
+        /**
+         * Set given zone name used
+         * by the report
+         */
+        static inline void setName(byte zone, const char* name)
+        {
+            if (zone < zoneCount) {
+                _names[zone] = name;
+            }
+        }
+
+        /**
+         * Add a measure of given
+         * cycles to given zone
+         * (overhead is subtracted)
+         */
+        static inline void add(byte zone, uint32_t cycles)
+        {
+            if (zone >= zoneCount) {
+                return;
+            }
+            cycles = cycles > _overhead ? cycles - _overhead : 0;
+            logic state = isr::getState();
+            isr::disable();
+            Stats& stats = _stats[zone];
+            stats.count++;
+            if (cycles > 0xFFFFFFFF - stats.total) {
+                stats.total = 0xFFFFFFFF;
+            } else {
+                stats.total += cycles;
+            }
+            if (cycles < stats.min) {
+                stats.min = cycles;
+            }
+            if (cycles > stats.max) {
+                stats.max = cycles;
+            }
+            isr::setState(state);
+        }
+
+        /**
+         * Return given zone statistics
+         */
+        static inline Stats getStats(byte zone)
+        {
+            logic state = isr::getState();
+            isr::disable();
+            Stats stats = _stats[zone];
+            isr::setState(state);
+            return stats;
+        }
+
+        /**
+         * Return calibrated overhead in cycles
+         */
+        static inline uint32_t getOverhead()
+        {
+            return _overhead;
+        }
+
+        /**
+         * Reset given zone or all zones
+         */
+        static inline void reset(byte zone)
+        {
+            logic state = isr::getState();
+            isr::disable();
+            _stats[zone] = {0, 0xFFFFFFFF, 0, 0};
+            isr::setState(state);
+        }
+        static inline void resetAll()
+        {
+            for (byte zone=0;zone<zoneCount;zone++) {
+                reset(zone);
+            }
+        }
+
+        /**
+         * Print measured zones with Printer
+         * (name or number, count, min, max and
+         * average cycles and total milliseconds)
+         */
+        static inline void report()
+        {
+            Printer::write("zone count min max avg totalMs");
+            Printer::endl();
+            for (byte zone=0;zone<zoneCount;zone++) {
+                Stats stats = getStats(zone);
+                if (stats.count == 0) {
+                    continue;
+                }
+                if (_names[zone] != nullptr) {
+                    Printer::write(_names[zone]);
+                } else {
+                    Printer::write(zone);
+                }
+                Printer::write(' ');
+                Printer::write(stats.count);
+                Printer::write(' ');
+                Printer::write(stats.min);
+                Printer::write(' ');
+                Printer::write(stats.max);
+                Printer::write(' ');
+                Printer::write(stats.total/stats.count);
+                Printer::write(' ');
+                Printer::write(stats.total/(uint32_t)(F_CPU/1000));
+                Printer::endl();
+            }
+        }
+
+    private:
+
+        /**
+         * Zones statistics and names
+         */
+        static Stats _stats[zoneCount];
+        static const char* _names[zoneCount];
+
+        /**
+         * Measurement overhead in cycles
+         */
+        static uint32_t _overhead;
+};
+
+/**
+ * Declare a profiling scope in given zone
+ * until the end of the enclosing block
+ */
+#define PROFILE_CONCAT(a, b) a ## b
+#define PROFILE_SCOPE(zone, line) \
+    Profiler::Scope PROFILE_CONCAT(profilerScope, line)(zone)
+#define PROFILE_ZONE(zone) PROFILE_SCOPE(zone, __LINE__)
+
+/**
+ * Non const member definition
+ */
+Profiler::Stats Profiler::_stats[Profiler::zoneCount];
+const char* Profiler::_names[Profiler::zoneCount];
+uint32_t Profiler::_overhead = 0;
+
+#endif
+
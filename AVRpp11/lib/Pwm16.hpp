@@ -0,0 +1,215 @@
+#ifndef PWM16_HPP
+#define PWM16_HPP
+
+/**
+ * 16 bits Pwm on Timer1 A and B output
+ * with input capture register as TOP
+ *
+ * The clock prescaler and TOP value are computed
+ * from the target Pwm frequency in order to get the
+ * highest possible resolution. Both OC1A and OC1B pins
+ * are available as outputs. Duty cycle updates are
+ * double buffered by the hardware (applied at TOP for fast
+ * and phase correct modes and at BOTTOM for phase and
+ * frequency correct mode) so no glitch can occur.
+ * (Timer1 is owned by the Pwm)
+ */
+class Pwm16
+{
+    public:
+
+        /**
+         * Pwm output channel
+         */
+        enum Channel : byte {
+            ChannelA,
+            ChannelB,
+        };
+
+        /**
+         * Pwm generation mode
+         * Fast : single slope, highest frequency
+         * Phase : dual slope, phase correct
+         * PhaseFreq : dual slope, phase and frequency correct
+         */
+        enum Mode : byte {
+            ModeFast,
+            ModePhase,
+            ModePhaseFreq,
+        };
+
+        /**
+         * Configure Timer1 for given Pwm frequency
+         * in Hertz and mode. Both duty cycles are reset
+         * to zero and outputs are disabled.
+         * Return the actual Pwm frequency (zero if
+         * given frequency can not be reached).
+         */
+        static inline uint32_t init(uint32_t frequency, Mode mode = ModeFast)
+        {
+            if (frequency == 0) {
+                return 0;
+            }
+            //Number of cpu cycles per (half for dual slope) period
+            uint32_t cycles = F_CPU/frequency;
+            if (mode != ModeFast) {
+                cycles /= 2;
+            }
+            //Find the smallest prescaler reaching the period
+            //(TOP is at most 0xFFFF)
+            uint32_t maxTicks = mode == ModeFast ? 0x10000 : 0xFFFF;
+            timer::TimerClock clock = timer::ClockDiv1;
+            word divider = 1;
+            while (cycles/divider > maxTicks) {
+                if (clock == timer::ClockDiv1) {
+                    clock = timer::ClockDiv8;
+                    divider = 8;
+                } else if (clock == timer::ClockDiv8) {
+                    clock = timer::ClockDiv64;
+                    divider = 64;
+                } else if (clock == timer::ClockDiv64) {
+                    clock = timer::ClockDiv256;
+                    divider = 256;
+                } else if (clock == timer::ClockDiv256) {
+                    clock = timer::ClockDiv1024;
+                    divider = 1024;
+                } else {
+                    return 0;
+                }
+            }
+            uint32_t ticks = cycles/divider;
+            if (ticks < 4) {
+                return 0;
+            }
+
+            isr::disable();
+            timer::Timer1.setClock(timer::ClockStop);
+            timer::Timer1.setPinModeA(timer::PinDisable);
+            timer::Timer1.setPinModeB(timer::PinDisable);
+            if (mode == ModeFast) {
+                _top = ticks - 1;
+                timer::Timer1.setCounterMode(timer::WavePwmTopCapture);
+            } else if (mode == ModePhase) {
+                _top = ticks;
+                timer::Timer1.setCounterMode(timer::WavePhasePwmTopCapture);
+            } else {
+                _top = ticks;
+                timer::Timer1.setCounterMode(
+                    timer::WavePhaseFreqPwmTopCapture);
+            }
+            _mode = mode;
+            _divider = divider;
+            timer::Timer1.writeCapture(_top);
+            timer::Timer1.writeCompareA(0);
+            timer::Timer1.writeCompareB(0);
+            timer::Timer1.writeCounter(0);
+            isr::enable();
+            timer::Timer1.setClock(clock);
+
+            return getFrequency();
+        }
+
+        /**
+         * Enable Pwm on given channel output pin
+         * (OC1A or OC1B) with normal or inverted polarity
+         * or disable it
+         */
+        static inline void enable(Channel channel, logic isInverted = False)
+        {
+            timer::TimerPinMode pinMode =
+                isInverted ? timer::PinPwmInv : timer::PinPwm;
+            if (channel == ChannelA) {
+                gpio::OC1A.setMode(gpio::Output);
+                timer::Timer1.setPinModeA(pinMode);
+            } else if (channel == ChannelB) {
+                gpio::OC1B.setMode(gpio::Output);
+                timer::Timer1.setPinModeB(pinMode);
+            }
+        }
+        static inline void disable(Channel channel)
+        {
+            if (channel == ChannelA) {
+                timer::Timer1.setPinModeA(timer::PinDisable);
+            } else if (channel == ChannelB) {
+                timer::Timer1.setPinModeB(timer::PinDisable);
+            }
+        }
+
+        /**
+         * Set given channel duty cycle as a fraction
+         * of the period (0 is 0%, 0xFFFF is 100%)
+         */
+        static inline void setDuty(Channel channel, word duty)
+        {
+            uint32_t value = ((uint32_t)duty*(_top + 1)) >> 16;
+            if (duty == 0xFFFF) {
+                value = _top;
+            }
+            writeRaw(channel, value);
+        }
+
+        /**
+         * Set given channel compare value
+         * (between 0 and TOP)
+         * The 16 bits register write is protected
+         * against interrupts using the shared TEMP register.
+         */
+        static inline void writeRaw(Channel channel, word value)
+        {
+            logic state = isr::getState();
+            isr::disable();
+            if (channel == ChannelA) {
+                timer::Timer1.writeCompareA(value);
+            } else if (channel == ChannelB) {
+                timer::Timer1.writeCompareB(value);
+            }
+            isr::setState(state);
+        }
+
+        /**
+         * Return current TOP value, resolution
+         * in bits and actual Pwm frequency in Hertz
+         */
+        static inline word getTop()
+        {
+            return _top;
+        }
+        static inline byte getResolution()
+        {
+            byte resolution = 0;
+            uint32_t steps = (uint32_t)_top + 1;
+            while (steps > 1) {
+                steps >>= 1;
+                resolution++;
+            }
+            return resolution;
+        }
+        static inline uint32_t getFrequency()
+        {
+            if (_mode == ModeFast) {
+                return F_CPU/((uint32_t)_divider*((uint32_t)_top + 1));
+            } else {
+                return F_CPU/((uint32_t)_divider*2*_top);
+            }
+        }
+
+    private:
+
+        /**
+         * Current TOP value, mode
+         * and clock divider
+         */
+        static word _top;
+        static Mode _mode;
+        static word _divider;
+};
+
+/**
+ * Non const member definition
+ */
+word Pwm16::_top = 0;
+Pwm16::Mode Pwm16::_mode = Pwm16::ModeFast;
+word Pwm16::_divider = 1;
+
+#endif
+
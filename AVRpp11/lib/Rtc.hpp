@@ -0,0 +1,161 @@
+#ifndef RTC_HPP
+#define RTC_HPP
+
+#include <avr/sleep.h>
+
+/**
+ * Real time clock using Timer2 in asynchronous
+ * mode with a 32.768kHz watch crystal on TOSC1/TOSC2
+ *
+ * With the 128 prescaler, Timer2 overflows exactly
+ * once per second and the counter gives 1/256 second
+ * fractions. Timer2 keeps running in power save sleep
+ * mode and its overflow wakes the cpu up.
+ * (The crystal pins are shared with PB6/PB7, so
+ * the internal oscillator has to be used as cpu clock)
+ */
+class Rtc
+{
+    public:
+
+        /**
+         * Wall clock time broken down
+         * from the seconds counter
+         */
+        struct Time {
+            word days;
+            byte hours;
+            byte minutes;
+            byte seconds;
+        };
+
+        /**
+         * Start Timer2 asynchronous clock and
+         * the seconds counter at given value
+         * (Follows the datasheet asynchronous
+         * switch procedure, the crystal may need
+         * up to one second to stabilize)
+         */
+        static inline void init(uint32_t seconds = 0)
+        {
+            isr::disable();
+            //Disable Timer2 interrupts before the switch
+            timer::Timer2.onMatchA();
+            timer::Timer2.onMatchB();
+            timer::Timer2.onOverflow();
+            timer::Timer2.setAsynchronous(True);
+            //Rewrite registers in asynchronous domain
+            timer::Timer2.writeCounter(0);
+            timer::Timer2.writeCompareA(0);
+            timer::Timer2.writeCompareB(0);
+            timer::Timer2.setCounterMode(timer::WaveNormalTopNormal);
+            timer::Timer2.setPinModeA(timer::PinDisable);
+            timer::Timer2.setPinModeB(timer::PinDisable);
+            timer::Timer2.setClock(timer::ClockDiv128);
+            timer::Timer2.waitUpdate();
+            //Clear spurious flags
+            timer::Timer2.clearMatchA();
+            timer::Timer2.clearMatchB();
+            timer::Timer2.clearOverflow();
+            _seconds = seconds;
+            timer::Timer2.onOverflow(Rtc::isrHandler);
+            isr::enable();
+        }
+
+        /**
+         * Return the seconds counter
+         */
+        static inline uint32_t now()
+        {
+            isr::disable();
+            uint32_t seconds = _seconds;
+            isr::enable();
+            return seconds;
+        }
+
+        /**
+         * Set the seconds counter
+         * and reset the second fraction
+         */
+        static inline void set(uint32_t seconds)
+        {
+            isr::disable();
+            timer::Timer2.writeCounter(0);
+            timer::Timer2.waitUpdate();
+            timer::Timer2.clearOverflow();
+            _seconds = seconds;
+            isr::enable();
+        }
+
+        /**
+         * Return current second fraction
+         * in 1/256 seconds
+         * (After a wake up from sleep, the value
+         * is only valid after synchronization,
+         * see sleep())
+         */
+        static inline byte readFraction()
+        {
+            return timer::Timer2.readCounter();
+        }
+
+        /**
+         * Return the seconds counter broken down
+         * in days, hours, minutes and seconds
+         */
+        static inline Time getTime()
+        {
+            uint32_t seconds = now();
+            Time time;
+            uint32_t minutes = seconds/60;
+            time.seconds = seconds - minutes*60;
+            uint32_t hours = minutes/60;
+            time.minutes = minutes - hours*60;
+            time.days = hours/24;
+            time.hours = hours - (uint32_t)time.days*24;
+            return time;
+        }
+
+        /**
+         * Enter power save sleep until next interrupt
+         * (at most one second with the Rtc overflow).
+         * Waits one asynchronous clock cycle first so that
+         * the Timer2 interrupt logic is ready to wake the
+         * cpu again and synchronizes after the wake up so
+         * that the counter can be read.
+         */
+        static inline void sleep()
+        {
+            timer::Timer2.synchronize();
+            set_sleep_mode(SLEEP_MODE_PWR_SAVE);
+            isr::disable();
+            sleep_enable();
+            isr::enable();
+            sleep_cpu();
+            sleep_disable();
+            timer::Timer2.synchronize();
+        }
+
+        /**
+         * Timer2 overflow interrupt handler
+         */
+        static void isrHandler(HandlerArg(timer::Timer2) t)
+        {
+            _seconds++;
+        }
+
+    private:
+
+        /**
+         * Seconds counter
+         */
+        static volatile uint32_t _seconds;
+};
+
+/**
+ * Non const member definition
+ */
+volatile uint32_t Rtc::_seconds = 0;
+
+#endif
+
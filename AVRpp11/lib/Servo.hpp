@@ -0,0 +1,321 @@
+#ifndef SERVO_HPP
+#define SERVO_HPP
+
+/**
+ * Up to 12 hobby servos on any Gpio pin
+ * of ports B, C and D using Timer1
+ *
+ * Timer1 counts 20ms frames (prescaler 8, input
+ * capture register as TOP). All pulses start together
+ * at the frame start (compare A) and end at sorted
+ * times (compare B is reprogrammed to each next end,
+ * servos with the same end share one step).
+ * Compare interrupts are programmed earlyMicros ahead
+ * and spin on the counter up to the exact tick, so the
+ * pulse width jitter stays below 1us as long as other
+ * interrupt handlers are shorter than earlyMicros.
+ * Pulse updates are written in a back buffer and
+ * applied at next frame start by commit().
+ * (Timer1 is owned by the servo driver, F_CPU has
+ * to be 8 or 16MHz)
+ */
+class Servo
+{
+    public:
+
+        /**
+         * Define the maximum number of
+         * servos and the invalid servo id
+         */
+        static constexpr byte servoCount = 12;
+        static constexpr byte None = 0xFF;
+
+        /**
+         * Frame period, pulse bounds
+         * and interrupt advance in microseconds
+         */
+        static constexpr word frameMicros = 20000;
+        static constexpr word minMicros = 500;
+        static constexpr word maxMicros = 2500;
+        static constexpr word earlyMicros = 32;
+
+        /**
+         * Timer ticks per microsecond
+         */
+        static constexpr byte ticksPerMicro = F_CPU/8/1000000UL;
+        static_assert(ticksPerMicro == 1 || ticksPerMicro == 2,
+            "Servo requires F_CPU 8 or 16MHz");
+
+        /**
+         * Configure and start Timer1
+         * (no servo attached)
+         */
+        static inline void init()
+        {
+            isr::disable();
+            timer::Timer1.setClock(timer::ClockStop);
+            timer::Timer1.setCounterMode(timer::WaveNormalTopCapture);
+            timer::Timer1.setPinModeA(timer::PinDisable);
+            timer::Timer1.setPinModeB(timer::PinDisable);
+            timer::Timer1.writeCounter(0);
+            timer::Timer1.writeCapture(frameTop);
+            timer::Timer1.writeCompareA(frameTop - earlyTicks);
+            timer::Timer1.clearMatchA();
+            timer::Timer1.clearMatchB();
+            for (byte i=0;i<servoCount;i++) {
+                _pins[i] = nullptr;
+                _pulses[i] = 1500*ticksPerMicro;
+            }
+            _front = 0;
+            _isCommit = False;
+            build(_schedules[0]);
+            _step = 0;
+            timer::Timer1.onMatchA(Servo::isrFrame);
+            timer::Timer1.onMatchB(Servo::isrStep);
+            isr::enable();
+            timer::Timer1.setClock(timer::ClockDiv8);
+        }
+
+        /**
+         * Attach given pin as a new servo centered
+         * (1500us) at next commit and return its id
+         * or None if no servo is available.
+         * (The pin is set in output mode)
+         */
+        static inline byte attach(const gpio::GpioObject& pin)
+        {
+            for (byte id=0;id<servoCount;id++) {
+                if (_pins[id] == nullptr) {
+                    pin.write(Low);
+                    pin.setMode(gpio::Output);
+                    _pins[id] = &pin;
+                    _pulses[id] = 1500*ticksPerMicro;
+                    return id;
+                }
+            }
+            return None;
+        }
+
+        /**
+         * Remove given servo at next commit
+         * (its pin is then driven low)
+         */
+        static inline void detach(byte id)
+        {
+            if (id < servoCount) {
+                _pins[id] = nullptr;
+            }
+        }
+
+        /**
+         * Set given servo pulse width in microseconds
+         * (clamped between minMicros and maxMicros) or
+         * angle in degrees (0 to 180 for 1000us to 2000us)
+         * in the back buffer (applied at next commit)
+         */
+        static inline void setPulse(byte id, word micros)
+        {
+            if (id >= servoCount) {
+                return;
+            }
+            if (micros < minMicros) {
+                micros = minMicros;
+            } else if (micros > maxMicros) {
+                micros = maxMicros;
+            }
+            _pulses[id] = micros*ticksPerMicro;
+        }
+        static inline void setAngle(byte id, byte angle)
+        {
+            if (angle > 180) {
+                angle = 180;
+            }
+            setPulse(id, 1000 + ((word)angle*1000 + 90)/180);
+        }
+
+        /**
+         * Build the back schedule from attached
+         * servos and pulses and swap it at next frame
+         * start. Wait for the previous commit to be applied.
+         */
+        static inline void commit()
+        {
+            while (_isCommit == True);
+            build(_schedules[_front ^ 1]);
+            _isCommit = True;
+        }
+
+        /**
+         * Return true if last commit
+         * is not yet applied
+         */
+        static inline logic isCommitPending()
+        {
+            return _isCommit;
+        }
+
+        /**
+         * Timer1 compare A interrupt handler
+         * (frame start)
+         */
+        static void isrFrame(HandlerArg(timer::Timer1) t)
+        {
+            //Apply the commit before the frame
+            //start and drive detached pins low
+            if (_isCommit == True) {
+                const Schedule& previous = _schedules[_front];
+                _front ^= 1;
+                _isCommit = False;
+                const Schedule& next = _schedules[_front];
+                PORTB &= ~(previous.startMasks[0] & ~next.startMasks[0]);
+                PORTC &= ~(previous.startMasks[1] & ~next.startMasks[1]);
+                PORTD &= ~(previous.startMasks[2] & ~next.startMasks[2]);
+            }
+            const Schedule& schedule = _schedules[_front];
+            //Wait for the counter wrap
+            while (t.readCounter() >= frameTop - earlyTicks);
+            PORTB |= schedule.startMasks[0];
+            PORTC |= schedule.startMasks[1];
+            PORTD |= schedule.startMasks[2];
+            _step = 0;
+            if (schedule.count > 0) {
+                t.writeCompareB(schedule.times[0] - earlyTicks);
+                t.clearMatchB();
+            }
+        }
+
+        /**
+         * Timer1 compare B interrupt handler
+         * (pulse ends)
+         */
+        static void isrStep(HandlerArg(timer::Timer1) t)
+        {
+            const Schedule& schedule = _schedules[_front];
+            byte step = _step;
+            while (step < schedule.count) {
+                word time = schedule.times[step];
+                while (t.readCounter() < time);
+                PORTB &= ~schedule.masks[step][0];
+                PORTC &= ~schedule.masks[step][1];
+                PORTD &= ~schedule.masks[step][2];
+                step++;
+                //Wait for next step in this handler
+                //if it is too close for an interrupt
+                if (step < schedule.count &&
+                    (sword)(schedule.times[step] - t.readCounter()) >
+                    (sword)(2*earlyTicks)
+                ) {
+                    t.writeCompareB(schedule.times[step] - earlyTicks);
+                    break;
+                }
+            }
+            _step = step;
+        }
+
+    private:
+
+        /**
+         * Frame TOP and interrupt
+         * advance in timer ticks
+         */
+        static constexpr word frameTop = frameMicros*ticksPerMicro - 1;
+        static constexpr word earlyTicks = earlyMicros*ticksPerMicro;
+
+        /**
+         * Pulse schedule
+         * count : number of steps
+         * times : steps end time in ticks (sorted)
+         * masks : pins cleared at each step per port
+         * startMasks : pins set at frame start per port
+         */
+        struct Schedule {
+            byte count;
+            word times[servoCount];
+            byte masks[servoCount][3];
+            byte startMasks[3];
+        };
+
+        /**
+         * Front (running) and back schedules,
+         * next step and commit request
+         */
+        static Schedule _schedules[2];
+        static volatile byte _front;
+        static volatile byte _step;
+        static volatile logic _isCommit;
+
+        /**
+         * Servos pin (nullptr if not
+         * attached) and pulse in ticks
+         */
+        static const gpio::GpioObject* _pins[servoCount];
+        static word _pulses[servoCount];
+
+        /**
+         * Return given pin port index
+         */
+        static inline byte portIndex(const gpio::GpioObject& pin)
+        {
+            if (pin.outReg == &PORTB) {
+                return 0;
+            } else if (pin.outReg == &PORTC) {
+                return 1;
+            } else {
+                return 2;
+            }
+        }
+
+        /**
+         * Compute given schedule from
+         * attached servos pulses
+         */
+        static inline void build(Schedule& schedule)
+        {
+            schedule.count = 0;
+            for (byte p=0;p<3;p++) {
+                schedule.startMasks[p] = 0;
+            }
+            for (byte id=0;id<servoCount;id++) {
+                if (_pins[id] == nullptr) {
+                    continue;
+                }
+                word time = _pulses[id];
+                byte port = portIndex(*_pins[id]);
+                byte mask = bits::value<byte>(_pins[id]->num);
+                schedule.startMasks[port] |= mask;
+                //Insert in sorted steps or
+                //merge with the same end time
+                byte i = 0;
+                while (i < schedule.count && schedule.times[i] < time) {
+                    i++;
+                }
+                if (i == schedule.count || schedule.times[i] != time) {
+                    for (byte j=schedule.count;j>i;j--) {
+                        schedule.times[j] = schedule.times[j-1];
+                        for (byte p=0;p<3;p++) {
+                            schedule.masks[j][p] = schedule.masks[j-1][p];
+                        }
+                    }
+                    schedule.times[i] = time;
+                    for (byte p=0;p<3;p++) {
+                        schedule.masks[i][p] = 0;
+                    }
+                    schedule.count++;
+                }
+                schedule.masks[i][port] |= mask;
+            }
+        }
+};
+
+/**
+ * Non const member definition
+ */
+Servo::Schedule Servo::_schedules[2];
+volatile byte Servo::_front = 0;
+volatile byte Servo::_step = 0;
+volatile logic Servo::_isCommit = False;
+const gpio::GpioObject* Servo::_pins[Servo::servoCount];
+word Servo::_pulses[Servo::servoCount];
+
+#endif
+
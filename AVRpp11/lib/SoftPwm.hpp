@@ -0,0 +1,266 @@
+#ifndef SOFTPWM_HPP
+#define SOFTPWM_HPP
+
+/**
+ * 8 bits software Pwm on any Gpio pin of
+ * ports B, C and D using bit angle modulation
+ * on Timer2 compare B
+ *
+ * Each duty cycle bit k is shown for 2^k ticks of
+ * 64 cpu cycles. The output bytes of every port are
+ * precomputed for each of the 8 bit planes, so an
+ * interrupt writes three port bytes whatever the number
+ * of channels (7 interrupts per 255 ticks frame, plane 0
+ * and 1 are written from the same interrupt with a cycle
+ * exact delay). Frame rate is F_CPU/16320 (980Hz at 16MHz).
+ * Cpu load is estimated to about 5% (7 interrupts of
+ * about 100 cycles including the handler dispatch, plus
+ * the plane 0 delay, per frame).
+ * Duty updates are written in a back buffer and applied
+ * at the next frame start by commit().
+ * Only attached pins are written by the interrupt, but
+ * other pins of the same ports have to be written atomically
+ * (single bit write or interrupts disabled).
+ * (Timer2 is owned by the Pwm)
+ */
+class SoftPwm
+{
+    public:
+
+        /**
+         * Number of bit planes, handled ports
+         * and timer tick in cpu cycles
+         */
+        static constexpr byte planeCount = 8;
+        static constexpr byte portCount = 3;
+        static constexpr byte tickCycles = 64;
+
+        /**
+         * Configure and start Timer2
+         * (all duty cycles are zero)
+         */
+        static inline void init()
+        {
+            isr::disable();
+            timer::Timer2.setClock(timer::ClockStop);
+            timer::Timer2.setCounterMode(timer::WaveNormalTopCompareA);
+            timer::Timer2.setPinModeA(timer::PinDisable);
+            timer::Timer2.setPinModeB(timer::PinDisable);
+            timer::Timer2.writeCounter(0);
+            timer::Timer2.writeCompareA(254);
+            timer::Timer2.writeCompareB(0);
+            timer::Timer2.clearMatchB();
+            _plane = 0;
+            _front = 0;
+            _isCommit = False;
+            for (byte p=0;p<portCount;p++) {
+                _masks[p] = 0;
+                for (byte i=0;i<8;i++) {
+                    _duties[p][i] = 0;
+                }
+            }
+            build(_frames[0]);
+            build(_frames[1]);
+            timer::Timer2.onMatchB(SoftPwm::isrHandler);
+            isr::enable();
+            timer::Timer2.setClock(timer::ClockDiv64);
+        }
+
+        /**
+         * Stop Timer2 and drive
+         * attached pins low
+         */
+        static inline void stop()
+        {
+            isr::disable();
+            timer::Timer2.setClock(timer::ClockStop);
+            timer::Timer2.onMatchB();
+            const Frame& frame = _frames[_front];
+            PORTB &= ~frame.masks[0];
+            PORTC &= ~frame.masks[1];
+            PORTD &= ~frame.masks[2];
+            isr::enable();
+        }
+
+        /**
+         * Add given pin to (or remove it from)
+         * the Pwm channels at next commit
+         * (the pin is set in output mode,
+         * a removed pin is driven low)
+         */
+        static inline void attach(const gpio::GpioObject& pin)
+        {
+            pin.write(Low);
+            pin.setMode(gpio::Output);
+            _masks[portIndex(pin)] |= bits::value<byte>(pin.num);
+        }
+        static inline void detach(const gpio::GpioObject& pin)
+        {
+            _masks[portIndex(pin)] &= ~bits::value<byte>(pin.num);
+            _duties[portIndex(pin)][pin.num] = 0;
+        }
+
+        /**
+         * Set given pin duty cycle
+         * (0 is 0%, 255 is 100%) in the back
+         * buffer (applied at next commit)
+         */
+        static inline void setDuty(const gpio::GpioObject& pin, byte duty)
+        {
+            _duties[portIndex(pin)][pin.num] = duty;
+        }
+
+        /**
+         * Build the back buffer from current
+         * channels and duty cycles and swap it
+         * at next frame start.
+         * Wait for the previous commit to be applied.
+         */
+        static inline void commit()
+        {
+            while (_isCommit == True);
+            build(_frames[_front ^ 1]);
+            _isCommit = True;
+        }
+
+        /**
+         * Return true if last commit
+         * is not yet applied
+         */
+        static inline logic isCommitPending()
+        {
+            return _isCommit;
+        }
+
+        /**
+         * Timer2 compare B interrupt handler
+         */
+        static void isrHandler(HandlerArg(timer::Timer2) t)
+        {
+            byte plane = _plane;
+            const Frame& frame = _frames[_front];
+            if (plane == 0) {
+                //One tick plane is too short for
+                //an interrupt, wait for it
+                write(frame, 0);
+                __builtin_avr_delay_cycles(tickCycles - writeCycles);
+                write(frame, 1);
+                t.writeCompareB(3);
+                _plane = 2;
+            } else {
+                write(frame, plane);
+                if (plane == planeCount-1) {
+                    t.writeCompareB(0);
+                    _plane = 0;
+                    //Swap at the end of the frame
+                    //and drive detached pins low
+                    if (_isCommit == True) {
+                        byte front = _front ^ 1;
+                        const Frame& next = _frames[front];
+                        PORTB &= ~(frame.masks[0] & ~next.masks[0]);
+                        PORTC &= ~(frame.masks[1] & ~next.masks[1]);
+                        PORTD &= ~(frame.masks[2] & ~next.masks[2]);
+                        _front = front;
+                        _isCommit = False;
+                    }
+                } else {
+                    t.writeCompareB((2 << plane) - 1);
+                    _plane = plane + 1;
+                }
+            }
+        }
+
+    private:
+
+        /**
+         * Approximate cpu cycles of one plane write
+         * (in, two ldd, com, and, or, out: 9 cycles
+         * per port). A mismatch with the generated code
+         * only lengthens or shortens the one tick plane
+         * by a few cycles.
+         */
+        static constexpr byte writeCycles = portCount*9;
+
+        /**
+         * Attached pins mask and
+         * bit plane bytes of each port
+         */
+        struct Frame {
+            byte masks[portCount];
+            byte planes[planeCount][portCount];
+        };
+
+        /**
+         * Front (displayed) and back frames,
+         * next displayed plane and commit request
+         */
+        static Frame _frames[2];
+        static volatile byte _front;
+        static volatile byte _plane;
+        static volatile logic _isCommit;
+
+        /**
+         * Attached pins mask and duty
+         * cycle of each port pin
+         */
+        static byte _masks[portCount];
+        static byte _duties[portCount][8];
+
+        /**
+         * Return given pin port index
+         */
+        static inline byte portIndex(const gpio::GpioObject& pin)
+        {
+            if (pin.outReg == &PORTB) {
+                return 0;
+            } else if (pin.outReg == &PORTC) {
+                return 1;
+            } else {
+                return 2;
+            }
+        }
+
+        /**
+         * Compute given frame bit planes
+         */
+        static inline void build(Frame& frame)
+        {
+            for (byte p=0;p<portCount;p++) {
+                byte mask = _masks[p];
+                frame.masks[p] = mask;
+                for (byte k=0;k<planeCount;k++) {
+                    byte value = 0;
+                    for (byte i=0;i<8;i++) {
+                        if (bits::get(_duties[p][i], (bits::BitNum)k)) {
+                            value |= 1 << i;
+                        }
+                    }
+                    frame.planes[k][p] = value & mask;
+                }
+            }
+        }
+
+        /**
+         * Write given frame plane
+         * on attached pins
+         */
+        static inline void write(const Frame& frame, byte plane)
+        {
+            PORTB = (PORTB & ~frame.masks[0]) | frame.planes[plane][0];
+            PORTC = (PORTC & ~frame.masks[1]) | frame.planes[plane][1];
+            PORTD = (PORTD & ~frame.masks[2]) | frame.planes[plane][2];
+        }
+};
+
+/**
+ * Non const member definition
+ */
+SoftPwm::Frame SoftPwm::_frames[2];
+volatile byte SoftPwm::_front = 0;
+volatile byte SoftPwm::_plane = 0;
+volatile logic SoftPwm::_isCommit = False;
+byte SoftPwm::_masks[SoftPwm::portCount];
+byte SoftPwm::_duties[SoftPwm::portCount][8];
+
+#endif
+
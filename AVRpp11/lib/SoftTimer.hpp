@@ -0,0 +1,297 @@
+#ifndef SOFTTIMER_HPP
+#define SOFTTIMER_HPP
+
+#include "SystemClock.hpp"
+
+/**
+ * Maximum number of software timers
+ * (can be defined before inclusion, each
+ * timer uses 14 bytes of RAM)
+ */
+#ifndef AVRPP11_SOFTTIMER_COUNT
+#define AVRPP11_SOFTTIMER_COUNT 16
+#endif
+
+/**
+ * Tickless software timers multiplexed
+ * on Timer1 compare A
+ *
+ * Active timers are kept in a deadline sorted
+ * list and compare A register is programmed to the
+ * nearest deadline (SystemClock timebase, in cpu
+ * cycles). No interrupt occurs while no timer is
+ * active, and one compare interrupt occurs per actual
+ * expiry (plus one every 65536 cycles while the
+ * nearest deadline is further away).
+ * Callbacks run either in interrupt context or are
+ * deferred to dispatch() called from the main loop.
+ * A periodic timer fires at most once per interrupt,
+ * missed periods (late interrupt or callback longer
+ * than the period) are skipped.
+ * SystemClock has to be initialized first.
+ */
+class SoftTimer
+{
+    public:
+
+        /**
+         * Timer callback
+         */
+        typedef void (*Callback)();
+
+        /**
+         * Callback execution context
+         * Isr : called from the compare interrupt
+         * Deferred : called from dispatch()
+         */
+        enum Context : byte {
+            ContextIsr,
+            ContextDeferred,
+        };
+
+        /**
+         * Define the maximum number of timers
+         * and the invalid timer id
+         */
+        static constexpr byte timerCount = AVRPP11_SOFTTIMER_COUNT;
+        static constexpr byte None = 0xFF;
+        static_assert(timerCount > 0 && timerCount < None,
+            "SoftTimer count has to be between 1 and 254");
+
+        /**
+         * Minimum distance in cycles between the compare
+         * register programming and the counter (a closer
+         * deadline is delayed by at most this value)
+         */
+        static constexpr word guardCycles = 64;
+
+        /**
+         * Minimum period in cycles of periodic timers
+         * (about the interrupt handler and a short
+         * callback duration)
+         */
+        static constexpr word periodMin = 256;
+
+        /**
+         * Start a timer calling given callback after given
+         * delay in cpu cycles (at most 2^31) and then every
+         * given period (zero for one-shot, else at least
+         * periodMin) in given context.
+         * Return the timer id or None if no timer is
+         * available or the period is too short.
+         * (Can be called from interrupt context)
+         */
+        static inline byte start(Callback callback, uint32_t delay,
+            uint32_t period = 0, Context context = ContextIsr)
+        {
+            if (period != 0 && period < periodMin) {
+                return None;
+            }
+            logic state = isr::getState();
+            isr::disable();
+            byte id = 0;
+            while (id < timerCount &&
+                (_isActive[id] == True || _pendingCount[id] != 0)
+            ) {
+                id++;
+            }
+            if (id == timerCount) {
+                isr::setState(state);
+                return None;
+            }
+            _callbacks[id] = callback;
+            _periods[id] = period;
+            _contexts[id] = context;
+            _deadlines[id] = SystemClock::cycles() + delay;
+            _isActive[id] = True;
+            insert(id);
+            program();
+            isr::setState(state);
+            return id;
+        }
+
+        /**
+         * Stop given timer and drop its
+         * pending deferred calls
+         * (Can be called from interrupt context)
+         */
+        static inline void stop(byte id)
+        {
+            if (id >= timerCount) {
+                return;
+            }
+            logic state = isr::getState();
+            isr::disable();
+            if (_isActive[id] == True) {
+                remove(id);
+                program();
+            }
+            _isActive[id] = False;
+            _pendingCount[id] = 0;
+            isr::setState(state);
+        }
+
+        /**
+         * Return true if given timer is running
+         */
+        static inline logic isActive(byte id)
+        {
+            return _isActive[id];
+        }
+
+        /**
+         * Call pending deferred callbacks
+         * (to be called from the main loop)
+         */
+        static inline void dispatch()
+        {
+            for (byte id=0;id<timerCount;id++) {
+                if (_pendingCount[id] == 0) {
+                    continue;
+                }
+                isr::disable();
+                _pendingCount[id]--;
+                Callback callback = _callbacks[id];
+                isr::enable();
+                callback();
+            }
+        }
+
+        /**
+         * Timer1 compare A interrupt handler
+         * Timers due at entry are handled, periodic ones
+         * are rearmed after current time so that the
+         * loop always ends. Timers expiring meanwhile
+         * are handled by next interrupt.
+         */
+        static void isrHandler(HandlerArg(timer::Timer1) t)
+        {
+            uint32_t now = SystemClock::cycles();
+            while (_head != None &&
+                (int32_t)(_deadlines[_head] - now) <= 0
+            ) {
+                byte id = _head;
+                _head = _next[id];
+                uint32_t period = _periods[id];
+                if (period != 0) {
+                    uint32_t deadline = _deadlines[id] + period;
+                    if ((int32_t)(deadline - now) <= 0) {
+                        //Skip missed periods
+                        deadline += ((now - deadline)/period + 1)*period;
+                    }
+                    _deadlines[id] = deadline;
+                    insert(id);
+                } else {
+                    _isActive[id] = False;
+                }
+                if (_contexts[id] == ContextIsr) {
+                    _callbacks[id]();
+                } else if (_pendingCount[id] != 0xFF) {
+                    _pendingCount[id]++;
+                }
+            }
+            program();
+        }
+
+    private:
+
+        /**
+         * Timers deadline in cycles, period,
+         * callback, context and state
+         */
+        static volatile uint32_t _deadlines[timerCount];
+        static uint32_t _periods[timerCount];
+        static Callback _callbacks[timerCount];
+        static Context _contexts[timerCount];
+        static volatile logic _isActive[timerCount];
+        static volatile byte _pendingCount[timerCount];
+
+        /**
+         * Deadline sorted list of active
+         * timers (head and next ids)
+         */
+        static volatile byte _head;
+        static volatile byte _next[timerCount];
+
+        /**
+         * Insert given timer in the sorted list
+         * (after timers with the same deadline)
+         * Interrupts have to be disabled
+         */
+        static inline void insert(byte id)
+        {
+            uint32_t deadline = _deadlines[id];
+            byte previous = None;
+            byte current = _head;
+            while (current != None &&
+                (int32_t)(_deadlines[current] - deadline) <= 0
+            ) {
+                previous = current;
+                current = _next[current];
+            }
+            _next[id] = current;
+            if (previous == None) {
+                _head = id;
+            } else {
+                _next[previous] = id;
+            }
+        }
+
+        /**
+         * Remove given timer from the sorted list
+         * Interrupts have to be disabled
+         */
+        static inline void remove(byte id)
+        {
+            if (_head == id) {
+                _head = _next[id];
+                return;
+            }
+            byte current = _head;
+            while (current != None) {
+                if (_next[current] == id) {
+                    _next[current] = _next[id];
+                    return;
+                }
+                current = _next[current];
+            }
+        }
+
+        /**
+         * Program compare A on the nearest deadline
+         * or disable the interrupt if no timer is active
+         * Interrupts have to be disabled
+         */
+        static inline void program()
+        {
+            if (_head == None) {
+                timer::Timer1.onMatchA();
+                return;
+            }
+            uint32_t deadline = _deadlines[_head];
+            uint32_t now = SystemClock::cycles();
+            if ((int32_t)(deadline - now) < (int32_t)guardCycles) {
+                deadline = now + guardCycles;
+            }
+            timer::Timer1.writeCompareA(deadline);
+            //Write one to OCF1A only, a pending
+            //overflow is kept for SystemClock
+            timer::Timer1.clearMatchA();
+            timer::Timer1.onMatchA(SoftTimer::isrHandler);
+        }
+};
+
+/**
+ * Non const member definition
+ */
+volatile uint32_t SoftTimer::_deadlines[SoftTimer::timerCount];
+uint32_t SoftTimer::_periods[SoftTimer::timerCount];
+SoftTimer::Callback SoftTimer::_callbacks[SoftTimer::timerCount];
+SoftTimer::Context SoftTimer::_contexts[SoftTimer::timerCount];
+volatile logic SoftTimer::_isActive[SoftTimer::timerCount];
+volatile byte SoftTimer::_pendingCount[SoftTimer::timerCount];
+volatile byte SoftTimer::_head = SoftTimer::None;
+volatile byte SoftTimer::_next[SoftTimer::timerCount];
+
+#endif
+
@@ -0,0 +1,175 @@
+#ifndef SYSTEMCLOCK_HPP
+#define SYSTEMCLOCK_HPP
+
+/**
+ * Monotonic system time using Timer1
+ * free running without prescaler
+ *
+ * Timer1 counts cpu cycles and its overflow
+ * interrupt (every 65536 cycles) only increments
+ * a 32 bits overflow counter and a sequence counter.
+ * Reads are tear free without long critical section:
+ * the overflow counter is read again if the sequence
+ * counter changed meanwhile, and a pending overflow
+ * is accounted when read with interrupts disabled
+ * (interrupts must not be disabled for more than
+ * 65536 cycles).
+ * Timer1 compare units stay available (counter mode
+ * must not be changed).
+ */
+class SystemClock
+{
+    public:
+
+        /**
+         * Number of cpu cycles per microsecond
+         * (F_CPU has to be 1, 2, 4, 8 or 16MHz)
+         */
+        static constexpr byte cyclesPerMicro = F_CPU/1000000UL;
+        static_assert(F_CPU % 1000000UL == 0 &&
+            (cyclesPerMicro == 1 || cyclesPerMicro == 2 ||
+            cyclesPerMicro == 4 || cyclesPerMicro == 8 ||
+            cyclesPerMicro == 16),
+            "SystemClock requires F_CPU power of two MHz");
+
+        /**
+         * Configure and start Timer1 at zero
+         */
+        static inline void init()
+        {
+            isr::disable();
+            timer::Timer1.setClock(timer::ClockStop);
+            timer::Timer1.setCounterMode(timer::WaveNormalTopNormal);
+            timer::Timer1.setPinModeA(timer::PinDisable);
+            timer::Timer1.setPinModeB(timer::PinDisable);
+            timer::Timer1.writeCounter(0);
+            timer::Timer1.clearOverflow();
+            _overflow = 0;
+            timer::Timer1.onOverflow(SystemClock::isrHandler);
+            isr::enable();
+            timer::Timer1.setClock(timer::ClockDiv1);
+        }
+
+        /**
+         * Return elapsed cpu cycles since init
+         * (wraps after 2^32 cycles, 268s at 16MHz)
+         */
+        static inline uint32_t cycles()
+        {
+            word counter;
+            uint32_t overflow = read(counter);
+            return (overflow << 16) | counter;
+        }
+
+        /**
+         * Return elapsed microseconds since init
+         * (wraps after 2^32 microseconds, 71 minutes)
+         */
+        static inline uint32_t micros()
+        {
+            word counter;
+            uint32_t overflow = read(counter);
+            return (overflow << (16 - microsShift)) |
+                (counter >> microsShift);
+        }
+
+        /**
+         * Return elapsed milliseconds since init
+         * (wraps after 2^32 milliseconds, 49 days)
+         * Two 32 bits divisions by constant are used
+         * (slower than micros())
+         */
+        static inline uint32_t millis()
+        {
+            word counter;
+            uint32_t overflow = read(counter);
+            uint32_t high = overflow/1000;
+            uint32_t low = overflow - high*1000;
+            return high*microsPerOverflow +
+                (low*microsPerOverflow + (counter >> microsShift))/1000;
+        }
+
+        /**
+         * Return the low byte of the overflow counter
+         * (bits 16 to 23 of cycles(), single load but
+         * late by one if read while an overflow is pending)
+         */
+        static inline byte readOverflowLow()
+        {
+            return *reinterpret_cast<volatile byte*>(&_overflow);
+        }
+
+        /**
+         * Busy wait for given number of cpu cycles
+         * (relative to the call time)
+         */
+        static inline void waitCycles(uint32_t count)
+        {
+            uint32_t start = cycles();
+            while (cycles() - start < count);
+        }
+
+        /**
+         * Timer1 overflow interrupt handler
+         */
+        static void isrHandler(HandlerArg(timer::Timer1) t)
+        {
+            _overflow++;
+            _sequence++;
+        }
+
+    private:
+
+        /**
+         * Counter shift for microseconds conversion
+         * and microseconds per Timer1 overflow
+         */
+        static constexpr byte microsShift =
+            cyclesPerMicro == 16 ? 4 : cyclesPerMicro == 8 ? 3 :
+            cyclesPerMicro == 4 ? 2 : cyclesPerMicro == 2 ? 1 : 0;
+        static constexpr uint32_t microsPerOverflow =
+            0x10000UL >> microsShift;
+
+        /**
+         * Timer1 overflow and
+         * update sequence counters
+         */
+        static volatile uint32_t _overflow;
+        static volatile byte _sequence;
+
+        /**
+         * Read consistent Timer1 counter into given
+         * word and return associated overflow counter
+         */
+        static inline uint32_t read(word& counter)
+        {
+            uint32_t overflow;
+            byte sequence;
+            do {
+                sequence = _sequence;
+                overflow = _overflow;
+                //Only the 16 bits counter read (shared TEMP
+                //register) and the flag are protected
+                logic state = isr::getState();
+                isr::disable();
+                counter = timer::Timer1.readCounter();
+                logic isPending = timer::Timer1.isOverflow();
+                isr::setState(state);
+                //Overflow not yet handled (interrupts
+                //disabled by the caller)
+                if (isPending == True && counter < 0x8000) {
+                    overflow++;
+                }
+            } while (sequence != _sequence);
+            return overflow;
+        }
+};
+
+/**
+ * Non const member definition
+ */
+volatile uint32_t SystemClock::_overflow = 0;
+volatile byte SystemClock::_sequence = 0;
+
+#endif
+
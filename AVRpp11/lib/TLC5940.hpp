@@ -0,0 +1,393 @@
+#ifndef TLC5940_HPP
+#define TLC5940_HPP
+
+/**
+ * TLC5940 16 channels 12 bits Pwm
+ * led driver for given number of daisy
+ * chained devices
+ *
+ * SIN and SCLK are driven by Spi (MOSI, SCK),
+ * GSCLK by Timer2 on OC2B (F_CPU/4), BLANK and
+ * XLAT by Timer1 on OC1B and OC1A (phase and frequency
+ * correct Pwm, one period per 4096 GSCLK so the Pwm
+ * frequency is F_CPU/16384). BLANK and XLAT pulses
+ * occur at Timer1 BOTTOM, XLAT is only connected to its
+ * pin for the period following a data upload so that new
+ * grayscale data is latched at the start of a Pwm cycle.
+ * Grayscale values are written in a back buffer and sent
+ * by update() either polled (no copy, about 18 cycles
+ * per byte: 3500 cycles for 8 devices) or from the Spi
+ * interrupt (the back buffer is copied and the upload
+ * runs in background).
+ * Dot correction is uploaded with the VPRG pin
+ * (DCPRG has to be tied high).
+ * (Timer1, Timer2 and Spi are owned by the driver)
+ */
+template <byte Devices>
+class TLC5940
+{
+    /**
+     * Grayscale double buffer and dot correction
+     * take 60 bytes of RAM per device
+     */
+    static_assert(Devices > 0 && Devices <= 16,
+        "TLC5940 supports 1 to 16 chained devices");
+
+    public:
+
+        /**
+         * Upload transmission mode
+         * Interrupt : one Spi interrupt per byte,
+         * update() returns immediately
+         * Polled : update() waits for each byte
+         */
+        enum TransferMode : byte {
+            TransferInterrupt,
+            TransferPolled,
+        };
+
+        /**
+         * Number of channels and grayscale
+         * and dot correction frame sizes in bytes
+         */
+        static constexpr word channelCount = (word)Devices*16;
+        static constexpr word frameSize = (word)Devices*24;
+        static constexpr word dotSize = (word)Devices*12;
+
+        /**
+         * Initialize Spi, Timer1 and Timer2, clear
+         * grayscale data and start Pwm generation.
+         * The VPRG pin is given for dot correction
+         * upload (tied low otherwise).
+         */
+        static inline void init(const gpio::GpioObject& vprgPin)
+        {
+            _vprgPin = &vprgPin;
+            _vprgPin->write(Low);
+            _vprgPin->setMode(gpio::Output);
+            init();
+        }
+        static inline void init()
+        {
+            isr::disable();
+            //Spi mode 0 (data sampled on SCLK rising edge)
+            spi::Spi.setMode(spi::Master);
+            spi::Spi.setBitOrder(spi::MSBFirst);
+            spi::Spi.setClockIdle(spi::ClockLow);
+            spi::Spi.setClockEdge(spi::ClockTrailing);
+            spi::Spi.setClockDivider(spi::ClockDiv2);
+            spi::Spi.onTransfertComplet();
+
+            //BLANK high until the timers are started
+            gpio::OC1A.write(Low);
+            gpio::OC1A.setMode(gpio::Output);
+            gpio::OC1B.write(High);
+            gpio::OC1B.setMode(gpio::Output);
+            gpio::OC2B.setMode(gpio::Output);
+
+            //BLANK and XLAT timing
+            timer::Timer1.setClock(timer::ClockStop);
+            timer::Timer1.setCounterMode(
+                timer::WavePhaseFreqPwmTopCapture);
+            timer::Timer1.writeCapture(pwmTop);
+            timer::Timer1.writeCompareA(1);
+            timer::Timer1.writeCompareB(2);
+            timer::Timer1.setPinModeA(timer::PinDisable);
+            timer::Timer1.setPinModeB(timer::PinPwm);
+            timer::Timer1.writeCounter(0);
+            timer::Timer1.onOverflow();
+
+            //GSCLK generation
+            timer::Timer2.setClock(timer::ClockStop);
+            timer::Timer2.setCounterMode(timer::WavePwmTopCompareA);
+            timer::Timer2.writeCompareA(gsclkCycles - 1);
+            timer::Timer2.writeCompareB(0);
+            timer::Timer2.setPinModeA(timer::PinDisable);
+            timer::Timer2.setPinModeB(timer::PinPwm);
+            timer::Timer2.writeCounter(0);
+
+            for (word i=0;i<frameSize;i++) {
+                _back[i] = 0;
+                _front[i] = 0;
+            }
+            for (word i=0;i<dotSize;i++) {
+                _dots[i] = 0xFF;
+            }
+            _index = frameSize + 1;
+            _isLatchPending = False;
+            _isExtraClock = False;
+            isr::enable();
+
+            timer::Timer1.setClock(timer::ClockDiv1);
+            timer::Timer2.setClock(timer::ClockDiv1);
+        }
+
+        /**
+         * Set given channel (0 is the first channel
+         * of the device nearest to the controller)
+         * grayscale value (0 to 4095) in the back buffer
+         */
+        static inline void set(word channel, word value)
+        {
+            word position = (channelCount - 1) - channel;
+            word index = (position*3) >> 1;
+            if ((position & 1) == 0) {
+                _back[index] = value >> 4;
+                _back[index + 1] = (_back[index + 1] & 0x0F) |
+                    ((value << 4) & 0xF0);
+            } else {
+                _back[index] = (_back[index] & 0xF0) |
+                    ((value >> 8) & 0x0F);
+                _back[index + 1] = value & 0xFF;
+            }
+        }
+
+        /**
+         * Return given channel grayscale
+         * value from the back buffer
+         */
+        static inline word get(word channel)
+        {
+            word position = (channelCount - 1) - channel;
+            word index = (position*3) >> 1;
+            if ((position & 1) == 0) {
+                return ((word)_back[index] << 4) | (_back[index + 1] >> 4);
+            } else {
+                return ((word)(_back[index] & 0x0F) << 8) | _back[index + 1];
+            }
+        }
+
+        /**
+         * Set all channels grayscale value
+         * in the back buffer
+         */
+        static inline void setAll(word value)
+        {
+            byte first = value >> 4;
+            byte second = ((value << 4) & 0xF0) | ((value >> 8) & 0x0F);
+            byte third = value & 0xFF;
+            for (word i=0;i<frameSize;i+=3) {
+                _back[i] = first;
+                _back[i + 1] = second;
+                _back[i + 2] = third;
+            }
+        }
+
+        /**
+         * Upload the back buffer with given transfer
+         * mode, latched at next Pwm cycle start.
+         * Return false if the previous upload is not
+         * completed (nothing is done).
+         */
+        static inline logic update(TransferMode mode = TransferPolled)
+        {
+            if (isUpdatePending() == True) {
+                return False;
+            }
+            if (mode == TransferPolled) {
+                for (word i=0;i<frameSize;i++) {
+                    spi::Spi.write(_back[i]);
+                    while (!spi::Spi.isTransfertComplet());
+                }
+                requestLatch();
+            } else {
+                for (word i=0;i<frameSize;i++) {
+                    _front[i] = _back[i];
+                }
+                isr::disable();
+                _index = 1;
+                spi::Spi.onTransfertComplet(TLC5940::isrTransfer);
+                spi::Spi.write(_front[0]);
+                isr::enable();
+            }
+            return True;
+        }
+
+        /**
+         * Return true if an upload is
+         * running or not yet latched
+         */
+        static inline logic isUpdatePending()
+        {
+            isr::disable();
+            logic isPending = logic_cast((byte)(
+                _isLatchPending == True || _index <= frameSize));
+            isr::enable();
+            return isPending;
+        }
+
+        /**
+         * Set given channel dot correction
+         * (0 to 63) in the dot correction buffer
+         */
+        static inline void setDotCorrection(word channel, byte value)
+        {
+            word position = (channelCount - 1) - channel;
+            word index = (position*3) >> 2;
+            value &= 0x3F;
+            byte offset = position & 3;
+            if (offset == 0) {
+                _dots[index] = (_dots[index] & 0x03) | (value << 2);
+            } else if (offset == 1) {
+                _dots[index] = (_dots[index] & 0xFC) | (value >> 4);
+                _dots[index + 1] = (_dots[index + 1] & 0x0F) | (value << 4);
+            } else if (offset == 2) {
+                _dots[index] = (_dots[index] & 0xF0) | (value >> 2);
+                _dots[index + 1] = (_dots[index + 1] & 0x3F) | (value << 6);
+            } else {
+                _dots[index] = (_dots[index] & 0xC0) | value;
+            }
+        }
+
+        /**
+         * Upload and latch the dot correction buffer
+         * (polled, needs the VPRG pin, waits for a
+         * running grayscale upload to be completed)
+         */
+        static inline void uploadDotCorrection()
+        {
+            if (_vprgPin == nullptr) {
+                return;
+            }
+            while (isUpdatePending() == True);
+            _vprgPin->write(High);
+            for (word i=0;i<dotSize;i++) {
+                spi::Spi.write(_dots[i]);
+                while (!spi::Spi.isTransfertComplet());
+            }
+            //XLAT pin is not connected to Timer1
+            gpio::OC1A.write(High);
+            gpio::OC1A.write(Low);
+            _vprgPin->write(Low);
+            //First grayscale cycle after dot correction
+            //needs one more SCLK pulse after XLAT
+            _isExtraClock = True;
+        }
+
+        /**
+         * Spi transmission completed interrupt handler
+         * (send next byte)
+         */
+        static void isrTransfer(HandlerArg(spi::Spi) s)
+        {
+            word index = _index;
+            if (index < frameSize) {
+                s.write(_front[index]);
+                _index = index + 1;
+            } else {
+                s.onTransfertComplet();
+                requestLatch();
+            }
+        }
+
+        /**
+         * Timer1 overflow interrupt handler
+         * (latch requested too close to BOTTOM,
+         * connect XLAT for the next period)
+         */
+        static void isrArm(HandlerArg(timer::Timer1) t)
+        {
+            t.setPinModeA(timer::PinPwm);
+            t.onOverflow(TLC5940::isrLatch);
+        }
+
+        /**
+         * Timer1 overflow interrupt handler
+         * (XLAT pulse occured, disconnect it)
+         */
+        static void isrLatch(HandlerArg(timer::Timer1) t)
+        {
+            t.setPinModeA(timer::PinDisable);
+            t.onOverflow();
+            if (_isExtraClock == True) {
+                spi::Spi.setMode(spi::Disable);
+                gpio::SCK.write(High);
+                gpio::SCK.write(Low);
+                spi::Spi.setMode(spi::Master);
+                _isExtraClock = False;
+            }
+            _isLatchPending = False;
+        }
+
+    private:
+
+        /**
+         * GSCLK period in cpu cycles and
+         * Timer1 TOP (4096 GSCLK per period)
+         */
+        static constexpr byte gsclkCycles = 4;
+        static constexpr word pwmTop = 4096/2*gsclkCycles;
+
+        /**
+         * Timer1 ticks around BOTTOM in which XLAT
+         * is not connected since its pulse (down count
+         * match at 1) may already be over
+         */
+        static constexpr word latchGuard = 64;
+
+        /**
+         * Grayscale back (user) and front
+         * (interrupt upload) buffers in shift order
+         * and dot correction buffer
+         */
+        static byte _back[frameSize];
+        static byte _front[frameSize];
+        static byte _dots[dotSize];
+
+        /**
+         * Next uploaded byte (frameSize while the
+         * last byte is sent, frameSize + 1 when idle),
+         * latch and extra SCLK pulse requests
+         */
+        static volatile word _index;
+        static volatile logic _isLatchPending;
+        static volatile logic _isExtraClock;
+
+        /**
+         * VPRG pin (nullptr if tied low)
+         */
+        static const gpio::GpioObject* _vprgPin;
+
+        /**
+         * Connect XLAT pin to Timer1 for the
+         * next pulse (disconnected at BOTTOM) or
+         * at next BOTTOM if the counter is too close
+         * to it (latched one period later)
+         */
+        static inline void requestLatch()
+        {
+            logic state = isr::getState();
+            isr::disable();
+            _isLatchPending = True;
+            _index = frameSize + 1;
+            timer::Timer1.clearOverflow();
+            if (timer::Timer1.readCounter() < latchGuard) {
+                timer::Timer1.onOverflow(TLC5940::isrArm);
+            } else {
+                timer::Timer1.setPinModeA(timer::PinPwm);
+                timer::Timer1.onOverflow(TLC5940::isrLatch);
+            }
+            isr::setState(state);
+        }
+};
+
+/**
+ * Non const member definition
+ */
+template <byte Devices>
+byte TLC5940<Devices>::_back[TLC5940<Devices>::frameSize];
+template <byte Devices>
+byte TLC5940<Devices>::_front[TLC5940<Devices>::frameSize];
+template <byte Devices>
+byte TLC5940<Devices>::_dots[TLC5940<Devices>::dotSize];
+template <byte Devices>
+volatile word TLC5940<Devices>::_index = TLC5940<Devices>::frameSize + 1;
+template <byte Devices>
+volatile logic TLC5940<Devices>::_isLatchPending = False;
+template <byte Devices>
+volatile logic TLC5940<Devices>::_isExtraClock = False;
+template <byte Devices>
+const gpio::GpioObject* TLC5940<Devices>::_vprgPin = nullptr;
+
+#endif
+
@@ -0,0 +1,255 @@
+#ifndef TRACE_HPP
+#define TRACE_HPP
+
+#include "SystemClock.hpp"
+
+/**
+ * Timestamped binary event trace
+ * on SystemClock timebase
+ *
+ * Each TRACE(id, arg) stores a 6 bytes record
+ * (24 bits cycle timestamp, event id and 16 bits
+ * argument) in a circular RAM buffer, the oldest
+ * records being overwritten. A record costs about 35
+ * cycles (inlined, interrupts are disabled meanwhile)
+ * and can be written from interrupt handlers.
+ * A trigger event freezes the buffer after the given
+ * number of following records. The frozen buffer is
+ * sent as binary stream over Usart0 and rendered as a
+ * timeline by Tools/traceView (make trace-view).
+ * Timestamps wrap every 2^24 cycles (1s at 16MHz),
+ * records further apart are not ordered by the viewer.
+ * SystemClock has to be initialized and
+ * clear() called first.
+ *
+ * Trace::clear();
+ * Trace::setTrigger(EventOverrun, 16);
+ * TRACE(EventLoopStart, value);
+ * ...
+ * if (Trace::isFrozen()) {
+ *     Trace::dump();
+ * }
+ */
+class Trace
+{
+    public:
+
+        /**
+         * Define the number of records (power of two)
+         * and the reserved empty record id
+         */
+        static constexpr byte recordCount = 64;
+        static constexpr byte None = 0xFF;
+        static_assert((recordCount & (recordCount - 1)) == 0,
+            "Trace record count has to be a power of two");
+
+        /**
+         * Trace record
+         * counter : Timer1 counter (timestamp bits 0 to 15)
+         * overflow : SystemClock overflow (bits 16 to 23)
+         * id : event id (None if empty)
+         * arg : event argument
+         */
+        struct Record {
+            word counter;
+            byte overflow;
+            byte id;
+            word arg;
+        };
+
+        /**
+         * Empty the buffer, remove the
+         * trigger and resume recording
+         */
+        static inline void clear()
+        {
+            logic state = isr::getState();
+            isr::disable();
+            for (byte i=0;i<recordCount;i++) {
+                _records[i].id = None;
+            }
+            _head = 0;
+            _triggerId = None;
+            _triggerIndex = None;
+            _stopHead = None;
+            _isFrozen = False;
+            isr::setState(state);
+        }
+
+        /**
+         * Freeze the buffer when given event id has
+         * been recorded followed by given number of
+         * records (lower than recordCount)
+         */
+        static inline void setTrigger(byte id, byte postCount)
+        {
+            logic state = isr::getState();
+            isr::disable();
+            _triggerId = id;
+            _postCount = postCount & (recordCount - 1);
+            isr::setState(state);
+        }
+
+        /**
+         * Stop or resume recording
+         * (a completed trigger is not rearmed)
+         */
+        static inline void freeze()
+        {
+            _isFrozen = True;
+        }
+        static inline void resume()
+        {
+            logic state = isr::getState();
+            isr::disable();
+            _stopHead = None;
+            _isFrozen = False;
+            isr::setState(state);
+        }
+
+        /**
+         * Return true if the buffer is frozen
+         * (trigger completed or freeze())
+         */
+        static inline logic isFrozen()
+        {
+            return _isFrozen;
+        }
+
+        /**
+         * Record given event id (not None)
+         * and argument with current timestamp
+         */
+        static inline void write(byte id, word arg)
+        {
+            logic state = isr::getState();
+            isr::disable();
+            if (!_isFrozen) {
+                byte index = _head;
+                Record& record = _records[index];
+                record.counter = TCNT1;
+                record.overflow = SystemClock::readOverflowLow();
+                record.id = id;
+                record.arg = arg;
+                byte next = (index + 1) & (recordCount - 1);
+                _head = next;
+                if (id == _triggerId) {
+                    trigger(index);
+                }
+                if (next == _stopHead) {
+                    _isFrozen = True;
+                }
+            }
+            isr::setState(state);
+        }
+
+        /**
+         * Return the record at given chronological
+         * index (0 is the oldest) of the frozen buffer
+         */
+        static inline Record read(byte index)
+        {
+            return _records[(byte)(_head + index) & (recordCount - 1)];
+        }
+
+        /**
+         * Return the chronological index of the
+         * triggering record or None if not triggered
+         */
+        static inline byte getTriggerIndex()
+        {
+            if (_triggerIndex == None) {
+                return None;
+            }
+            return (_triggerIndex - _head) & (recordCount - 1);
+        }
+
+        /**
+         * Freeze the buffer and send it as binary stream
+         * over Usart0 (configured in write mode and with
+         * Printer output flushed).
+         * Record count, trigger index and cpu cycles per
+         * microsecond are sent first followed by all records
+         * from the oldest (counter, overflow, id, argument,
+         * low byte first). Empty records have None id.
+         */
+        static inline void dump()
+        {
+            freeze();
+            dumpByte(recordCount);
+            dumpByte(getTriggerIndex());
+            dumpByte(SystemClock::cyclesPerMicro);
+            for (byte i=0;i<recordCount;i++) {
+                Record record = read(i);
+                dumpByte(record.counter & 0xFF);
+                dumpByte(record.counter >> 8);
+                dumpByte(record.overflow);
+                dumpByte(record.id);
+                dumpByte(record.arg & 0xFF);
+                dumpByte(record.arg >> 8);
+            }
+            while (!usart::Usart0.isDataSent());
+        }
+
+    private:
+
+        /**
+         * Records circular buffer
+         * and next write index
+         */
+        static Record _records[recordCount];
+        static volatile byte _head;
+
+        /**
+         * Trigger event id, post trigger record count,
+         * triggering record index and write index
+         * freezing the buffer (None when not triggered)
+         */
+        static volatile byte _triggerId;
+        static volatile byte _postCount;
+        static volatile byte _triggerIndex;
+        static volatile byte _stopHead;
+
+        /**
+         * Recording stopped
+         */
+        static volatile logic _isFrozen;
+
+        /**
+         * Handle the trigger event
+         * recorded at given index
+         */
+        static inline void trigger(byte index)
+        {
+            _triggerId = None;
+            _triggerIndex = index;
+            _stopHead = (index + 1 + _postCount) & (recordCount - 1);
+        }
+
+        /**
+         * Write a byte on Usart0 when ready
+         */
+        static inline void dumpByte(byte value)
+        {
+            while (!usart::Usart0.isWriteReady());
+            usart::Usart0.write(value);
+        }
+};
+
+/**
+ * Record given event id and argument
+ */
+#define TRACE(id, arg) Trace::write(id, arg)
+
+/**
+ * Non const member definition
+ */
+Trace::Record Trace::_records[Trace::recordCount];
+volatile byte Trace::_head = 0;
+volatile byte Trace::_triggerId = Trace::None;
+volatile byte Trace::_postCount = 0;
+volatile byte Trace::_triggerIndex = Trace::None;
+volatile byte Trace::_stopHead = Trace::None;
+volatile logic Trace::_isFrozen = False;
+
+#endif
@@ -34,7 +34,11 @@
     X(D13, SCK) \
     X(D12, MISO) \
     X(D11, MOSI) \
-    X(D10, SS)
+    X(D10, SS) \
+    X(D9, OC1A) \
+    X(D10, OC1B) \
+    X(D11, OC2A) \
+    X(D3, OC2B)
 
 #endif
 
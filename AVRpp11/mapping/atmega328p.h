@@ -31,7 +31,11 @@
     X(Pin19, SCK) \
     X(Pin18, MISO) \
     X(Pin17, MOSI) \
-    X(Pin16, SS)
+    X(Pin16, SS) \
+    X(Pin15, OC1A) \
+    X(Pin16, OC1B) \
+    X(Pin17, OC2A) \
+    X(Pin5, OC2B)
 
 #endif
 
@@ -231,6 +231,7 @@ SpiObject Spi = {
  */
 ISR(SPI_STC_vect)
 {
+    ISR_PROBE(isr::VectorSpi);
     if (Spi.onTransfertCompletFunc != SpiObject::Handler::Disable) {
         Spi.onTransfertCompletFunc(Spi);
     }
@@ -5,19 +5,41 @@ namespace timer {
 
 /**
  * Timer wave generation mode
- * WaveNormal and WavePwm
+ * WaveNormal, WavePwm (fast, single slope),
+ * WavePhasePwm (phase correct, dual slope) and
+ * WavePhaseFreqPwm (phase and frequency correct,
+ * dual slope, compare registers updated at bottom)
  * (See output pin mode)
  * and Timer Top counter mode
  * TopNormal : the counter is cleared when it overflow
  * TopCompareA : the counter is cleared when it matches
  * with A output compare register (therefor the output 
  * A Pin should not be used as output)
+ * TopCapture : the counter is cleared when it matches
+ * with input capture register (Timer1 only, both
+ * A and B output Pin are available)
+ * 8Bits, 9Bits, 10Bits : fixed top value 
+ * (Timer1 only, 8Bits is TopNormal on 8 bits timers)
+ * Modes not supported by a timer are ignored.
  */
 enum TimerCounterMode : byte {
     WaveNormalTopNormal,
     WaveNormalTopCompareA,
     WavePwmTopNormal,
     WavePwmTopCompareA,
+    WaveNormalTopCapture,
+    WavePwmTopCapture,
+    WavePwm8Bits,
+    WavePwm9Bits,
+    WavePwm10Bits,
+    WavePhasePwmTopNormal,
+    WavePhasePwmTopCompareA,
+    WavePhasePwmTopCapture,
+    WavePhasePwm8Bits,
+    WavePhasePwm9Bits,
+    WavePhasePwm10Bits,
+    WavePhaseFreqPwmTopCompareA,
+    WavePhaseFreqPwmTopCapture,
 };
 
 /**
@@ -50,6 +72,7 @@ enum TimerPinMode : byte {
  * 1 : no prescaler
  * 8, 64, 256, 1024 : prescaler value for internal
  * clock source division
+ * 32, 128 : additional prescaler values (Timer2 only)
  * ExternalFalling : the counter is incremented when
  * input pin received falling edge
  * ExternalRising : the counter is incremented when
@@ -66,8 +89,188 @@ enum TimerClock : byte {
     ClockDiv1024,
     ClockExternalFalling,
     ClockExternalRising,
+    ClockDiv32,
+    ClockDiv128,
 }; 
 
+/**
+ * Timer counter width
+ */
+enum TimerWidth : byte {
+    Width8Bits,
+    Width16Bits,
+};
+
+/**
+ * Timer available prescaler set
+ * Timer01 : 1, 8, 64, 256, 1024 (Timer0 and Timer1)
+ * Timer2 : 1, 8, 32, 64, 128, 256, 1024
+ */
+enum TimerPrescalers : byte {
+    PrescalersTimer01,
+    PrescalersTimer2,
+};
+
+/**
+ * Compare match (WaveNormalTopCompareA) period
+ * setting computed by solveTimer()
+ * Width, Prescalers : timer the setting is solved for
+ * Clock : prescaler (ClockStop if the period
+ * can not be reached)
+ * Top : compare A register value
+ * Cycles : achieved period in cpu cycles
+ * ErrorPpm : relative period error in part per million
+ */
+struct TimerSetting {
+    TimerWidth width;
+    TimerPrescalers prescalers;
+    TimerClock clock;
+    word top;
+    uint32_t cycles;
+    uint32_t errorPpm;
+};
+
+/**
+ * Return the number of cpu cycles
+ * of given frequency in Hertz or
+ * given period in microseconds
+ */
+constexpr inline uint32_t cyclesFromFrequency(uint32_t frequency)
+{
+    return (F_CPU + frequency/2)/frequency;
+}
+constexpr inline uint32_t cyclesFromMicros(uint32_t micros)
+{
+    return ((unsigned long long)F_CPU*micros + 500000)/1000000;
+}
+
+/**
+ * Return the divider and the clock of
+ * given prescaler set index (from the smallest)
+ * Divider is zero past the last prescaler
+ */
+constexpr inline word timerDivider(TimerPrescalers prescalers, byte index)
+{
+    return prescalers == PrescalersTimer01 ?
+        (index == 0 ? 1 : index == 1 ? 8 : index == 2 ? 64 :
+        index == 3 ? 256 : index == 4 ? 1024 : 0) :
+        (index == 0 ? 1 : index == 1 ? 8 : index == 2 ? 32 :
+        index == 3 ? 64 : index == 4 ? 128 : index == 5 ? 256 :
+        index == 6 ? 1024 : 0);
+}
+constexpr inline TimerClock timerDividerClock(word divider)
+{
+    return divider == 1 ? ClockDiv1 : divider == 8 ? ClockDiv8 :
+        divider == 32 ? ClockDiv32 : divider == 64 ? ClockDiv64 :
+        divider == 128 ? ClockDiv128 : divider == 256 ? ClockDiv256 :
+        divider == 1024 ? ClockDiv1024 : ClockStop;
+}
+
+/**
+ * Return the clock select bits (control B register)
+ * of given internal clock for given prescaler set
+ */
+constexpr inline byte timerClockBits(TimerClock clock, 
+    TimerPrescalers prescalers)
+{
+    return prescalers == PrescalersTimer01 ?
+        (clock == ClockDiv1 ? 1 : clock == ClockDiv8 ? 2 :
+        clock == ClockDiv64 ? 3 : clock == ClockDiv256 ? 4 :
+        clock == ClockDiv1024 ? 5 : 0) :
+        (clock == ClockDiv1 ? 1 : clock == ClockDiv8 ? 2 :
+        clock == ClockDiv32 ? 3 : clock == ClockDiv64 ? 4 :
+        clock == ClockDiv128 ? 5 : clock == ClockDiv256 ? 6 :
+        clock == ClockDiv1024 ? 7 : 0);
+}
+
+/**
+ * Return the relative error in part per million
+ * of given period difference against target period
+ * in cycles (32 bits arithmetic, saturated above 4294
+ * cycles of difference, solved periods are within half
+ * a prescaler divider)
+ */
+constexpr inline uint32_t timerErrorPpm(uint32_t difference, uint32_t target)
+{
+    return target == 0 || difference > 0xFFFFFFFFUL/1000000 ?
+        0xFFFFFFFF : difference*1000000/target;
+}
+
+/**
+ * Build a setting for given timer from given divider
+ * and number of timer ticks per period
+ */
+constexpr inline TimerSetting timerSetting(TimerWidth width,
+    TimerPrescalers prescalers, word divider,
+    uint32_t ticks, uint32_t cycles)
+{
+    return TimerSetting{
+        width, prescalers,
+        timerDividerClock(divider), (word)(ticks - 1),
+        ticks*divider, timerErrorPpm(ticks*divider > cycles ?
+            ticks*divider - cycles : cycles - ticks*divider, cycles)};
+}
+
+/**
+ * Return the compare match setting reaching given period
+ * in cpu cycles for given timer width and prescaler set.
+ * The smallest prescaler fitting in the counter is chosen
+ * since it gives the finest period resolution.
+ * (Compile time evaluated when arguments are constant)
+ */
+constexpr inline TimerSetting solveTimer(uint32_t cycles, 
+    TimerWidth width, TimerPrescalers prescalers, byte index = 0)
+{
+    return timerDivider(prescalers, index) == 0 ?
+        TimerSetting{width, prescalers, ClockStop, 0, 0, 0xFFFFFFFF} :
+        (cycles + timerDivider(prescalers, index)/2)
+            /timerDivider(prescalers, index) > 
+            (width == Width8Bits ? 0x100UL : 0x10000UL) ?
+        solveTimer(cycles, width, prescalers, index + 1) :
+        timerSetting(width, prescalers, timerDivider(prescalers, index),
+            (cycles + timerDivider(prescalers, index)/2)
+            /timerDivider(prescalers, index) == 0 ? 1 :
+            (cycles + timerDivider(prescalers, index)/2)
+            /timerDivider(prescalers, index), cycles);
+}
+
+/**
+ * Compile time timer period solver
+ * Compilation fails if given period in cpu cycles
+ * can not be reached within given tolerance
+ * in part per million.
+ * Usage: Timer1.setPeriod(TimerPeriod<
+ *     cyclesFromFrequency(1000), Width16Bits, 
+ *     PrescalersTimer01, 100>::setting);
+ */
+template <uint32_t Cycles, TimerWidth Width, 
+    TimerPrescalers Prescalers, uint32_t TolerancePpm>
+struct TimerPeriod
+{
+    static constexpr TimerSetting setting = 
+        solveTimer(Cycles, Width, Prescalers);
+    static_assert(setting.clock != ClockStop, 
+        "Timer period is out of range");
+    static_assert(setting.clock == ClockStop || 
+        setting.errorPpm <= TolerancePpm, 
+        "Timer period error exceeds tolerance");
+};
+template <uint32_t Cycles, TimerWidth Width, 
+    TimerPrescalers Prescalers, uint32_t TolerancePpm>
+constexpr TimerSetting 
+    TimerPeriod<Cycles, Width, Prescalers, TolerancePpm>::setting;
+
+/**
+ * Timer1 input capture edge
+ * The counter value is copied into the
+ * capture register on given ICP1 pin
+ * (or Analog Comparator output) edge
+ */
+enum TimerCaptureEdge : byte {
+    CaptureFalling,
+    CaptureRising,
+};
+
 /**
  * Hardware Timer0 8 bits
  */
@@ -115,6 +318,18 @@ struct Timer0Object
         } else if (mode == WavePwmTopCompareA) {
             bits::add(*controlBReg, bits::Bit3);
             bits::add(*controlAReg, bits::Bit1, bits::Bit0);
+        } else if (mode == WavePwm8Bits) {
+            bits::add(*controlBReg, ~bits::Bit3);
+            bits::add(*controlAReg, bits::Bit1, bits::Bit0);
+        } else if (mode == WavePhasePwmTopNormal) {
+            bits::add(*controlBReg, ~bits::Bit3);
+            bits::add(*controlAReg, ~bits::Bit1, bits::Bit0);
+        } else if (mode == WavePhasePwmTopCompareA) {
+            bits::add(*controlBReg, bits::Bit3);
+            bits::add(*controlAReg, ~bits::Bit1, bits::Bit0);
+        } else if (mode == WavePhasePwm8Bits) {
+            bits::add(*controlBReg, ~bits::Bit3);
+            bits::add(*controlAReg, ~bits::Bit1, bits::Bit0);
         }
     }
 
@@ -179,6 +394,29 @@ struct Timer0Object
         }
     }
 
+    /**
+     * Configure compare match mode (WaveNormalTopCompareA)
+     * with given solved period. Control registers are each
+     * written once (see TimerPeriod).
+     * Return false and leave the timer unchanged if the
+     * setting was not solved for this timer width and
+     * prescaler set.
+     */
+    inline logic setPeriod(const TimerSetting& setting) const
+    {
+        if (
+            setting.width != Width8Bits || 
+            setting.prescalers != PrescalersTimer01
+        ) {
+            return False;
+        }
+        *compareAReg = setting.top;
+        *controlAReg = (*controlAReg & 0b11111100) | 0b00000010;
+        *controlBReg = (*controlBReg & 0b11110000) | 
+            timerClockBits(setting.clock, PrescalersTimer01);
+        return True;
+    }
+
     /**
      * Read and write to counter register
      */
@@ -234,18 +472,20 @@ struct Timer0Object
     /**
      * Manually clear compare match A, B 
      * and overflow flags
+     * (Flags are cleared by writing one, so only
+     * the given flag is written)
      */
     inline void clearMatchA() const
     {
-        bits::add(*flagReg, bits::Bit1);
+        bits::assign(*flagReg, bits::Bit1);
     }
     inline void clearMatchB() const
     {
-        bits::add(*flagReg, bits::Bit2);
+        bits::assign(*flagReg, bits::Bit2);
     }
     inline void clearOverflow() const
     {
-        bits::add(*flagReg, bits::Bit0);
+        bits::assign(*flagReg, bits::Bit0);
     }
     
     /**
@@ -321,6 +561,7 @@ struct Timer1Object
     Handler::type onMatchAFunc;
     Handler::type onMatchBFunc;
     Handler::type onOverflowFunc;
+    Handler::type onCaptureFunc;
 
     /**
      * Configure given timer wave and top counter mode
@@ -340,6 +581,46 @@ struct Timer1Object
         } else if (mode == WavePwmTopCompareA) {
             bits::add(*controlBReg, bits::Bit4, bits::Bit3);
             bits::add(*controlAReg, bits::Bit1, bits::Bit0);
+        } else if (mode == WaveNormalTopCapture) {
+            bits::add(*controlBReg, bits::Bit4, bits::Bit3);
+            bits::add(*controlAReg, ~bits::Bit1, ~bits::Bit0);
+        } else if (mode == WavePwmTopCapture) {
+            bits::add(*controlBReg, bits::Bit4, bits::Bit3);
+            bits::add(*controlAReg, bits::Bit1, ~bits::Bit0);
+        } else if (mode == WavePwm8Bits) {
+            bits::add(*controlBReg, ~bits::Bit4, bits::Bit3);
+            bits::add(*controlAReg, ~bits::Bit1, bits::Bit0);
+        } else if (mode == WavePwm9Bits) {
+            bits::add(*controlBReg, ~bits::Bit4, bits::Bit3);
+            bits::add(*controlAReg, bits::Bit1, ~bits::Bit0);
+        } else if (mode == WavePwm10Bits) {
+            bits::add(*controlBReg, ~bits::Bit4, bits::Bit3);
+            bits::add(*controlAReg, bits::Bit1, bits::Bit0);
+        } else if (mode == WavePhasePwmTopNormal) {
+            *captureReg = 0xFFFF;
+            bits::add(*controlBReg, bits::Bit4, ~bits::Bit3);
+            bits::add(*controlAReg, bits::Bit1, ~bits::Bit0);
+        } else if (mode == WavePhasePwmTopCompareA) {
+            bits::add(*controlBReg, bits::Bit4, ~bits::Bit3);
+            bits::add(*controlAReg, bits::Bit1, bits::Bit0);
+        } else if (mode == WavePhasePwmTopCapture) {
+            bits::add(*controlBReg, bits::Bit4, ~bits::Bit3);
+            bits::add(*controlAReg, bits::Bit1, ~bits::Bit0);
+        } else if (mode == WavePhasePwm8Bits) {
+            bits::add(*controlBReg, ~bits::Bit4, ~bits::Bit3);
+            bits::add(*controlAReg, ~bits::Bit1, bits::Bit0);
+        } else if (mode == WavePhasePwm9Bits) {
+            bits::add(*controlBReg, ~bits::Bit4, ~bits::Bit3);
+            bits::add(*controlAReg, bits::Bit1, ~bits::Bit0);
+        } else if (mode == WavePhasePwm10Bits) {
+            bits::add(*controlBReg, ~bits::Bit4, ~bits::Bit3);
+            bits::add(*controlAReg, bits::Bit1, bits::Bit0);
+        } else if (mode == WavePhaseFreqPwmTopCompareA) {
+            bits::add(*controlBReg, bits::Bit4, ~bits::Bit3);
+            bits::add(*controlAReg, ~bits::Bit1, bits::Bit0);
+        } else if (mode == WavePhaseFreqPwmTopCapture) {
+            bits::add(*controlBReg, bits::Bit4, ~bits::Bit3);
+            bits::add(*controlAReg, ~bits::Bit1, ~bits::Bit0);
         }
     }
 
@@ -404,6 +685,51 @@ struct Timer1Object
         }
     }
 
+    /**
+     * Configure input capture edge and
+     * noise canceler (the capture is delayed by
+     * four clock cycles and the input has to be
+     * stable during four samples)
+     * The capture flag is cleared since changing the 
+     * edge may trigger a capture
+     */
+    inline void setCaptureEdge(TimerCaptureEdge edge) const
+    {
+        if (edge == CaptureFalling) {
+            bits::add(*controlBReg, ~bits::Bit6);
+        } else if (edge == CaptureRising) {
+            bits::add(*controlBReg, bits::Bit6);
+        }
+        clearCapture();
+    }
+    inline void setCaptureNoiseCanceler(logic isEnabled) const
+    {
+        bits::set(*controlBReg, bits::Bit7, isEnabled);
+    }
+
+    /**
+     * Configure compare match mode (WaveNormalTopCompareA)
+     * with given solved period. Control registers are each
+     * written once (see TimerPeriod).
+     * Return false and leave the timer unchanged if the
+     * setting was not solved for this timer width and
+     * prescaler set.
+     */
+    inline logic setPeriod(const TimerSetting& setting) const
+    {
+        if (
+            setting.width != Width16Bits || 
+            setting.prescalers != PrescalersTimer01
+        ) {
+            return False;
+        }
+        *compareAReg = setting.top;
+        *controlAReg = *controlAReg & 0b11111100;
+        *controlBReg = (*controlBReg & 0b11100000) | 0b00001000 |
+            timerClockBits(setting.clock, PrescalersTimer01);
+        return True;
+    }
+
     /**
      * Read and write to counter register
      */
@@ -437,6 +763,358 @@ struct Timer1Object
         *compareBReg = value;
     }
 
+    /**
+     * Read and write to input capture register
+     * (Written only when used as TOP value)
+     */
+    inline word readCapture() const
+    {
+        return *captureReg;
+    }
+    inline void writeCapture(word value) const
+    {
+        *captureReg = value;
+    }
+
+    /**
+     * Return true when a compare match A, B,
+     * overflow or input capture has occured
+     * The flag is cleared manually or when associated 
+     * interruption is executed
+     */
+    inline logic isMatchA() const
+    {
+        return bits::get(*flagReg, bits::Bit1);
+    }
+    inline logic isMatchB() const
+    {
+        return bits::get(*flagReg, bits::Bit2);
+    }
+    inline logic isOverflow() const
+    {
+        return bits::get(*flagReg, bits::Bit0);
+    }
+    inline logic isCapture() const
+    {
+        return bits::get(*flagReg, bits::Bit5);
+    }
+
+    /**
+     * Manually clear compare match A, B,
+     * overflow and input capture flags
+     * (Flags are cleared by writing one, so only
+     * the given flag is written)
+     */
+    inline void clearMatchA() const
+    {
+        bits::assign(*flagReg, bits::Bit1);
+    }
+    inline void clearMatchB() const
+    {
+        bits::assign(*flagReg, bits::Bit2);
+    }
+    inline void clearOverflow() const
+    {
+        bits::assign(*flagReg, bits::Bit0);
+    }
+    inline void clearCapture() const
+    {
+        bits::assign(*flagReg, bits::Bit5);
+    }
+    
+    /**
+     * Initialize and set up interrupt routine
+     * with given callback fired when 
+     * the A and B compare match or overflow occured
+     * Or disable the interrupt
+     *
+     * For WaveNormal, overflow occurs at MAX value (0xFFFF)
+     * and for WavePwn, overflow occurs at TOP value (before 
+     * the counter loops to zero)
+     */
+    inline void onMatchA
+        (Handler::type handler = Handler::Disable)
+    {
+        onMatchAFunc = handler;
+        if (handler != Handler::Disable) {
+            bits::add(*maskReg, bits::Bit1);
+        } else {
+            bits::add(*maskReg, ~bits::Bit1);
+        }
+    }
+    inline void onMatchB
+        (Handler::type handler = Handler::Disable)
+    {
+        onMatchBFunc = handler;
+        if (handler != Handler::Disable) {
+            bits::add(*maskReg, bits::Bit2);
+        } else {
+            bits::add(*maskReg, ~bits::Bit2);
+        }
+    }
+    inline void onOverflow
+        (Handler::type handler = Handler::Disable)
+    {
+        onOverflowFunc = handler;
+        if (handler != Handler::Disable) {
+            bits::add(*maskReg, bits::Bit0);
+        } else {
+            bits::add(*maskReg, ~bits::Bit0);
+        }
+    }
+
+    /**
+     * Initialize and set up interrupt routine
+     * with given callback fired when 
+     * an input capture occured
+     * Or disable the interrupt
+     */
+    inline void onCapture
+        (Handler::type handler = Handler::Disable)
+    {
+        onCaptureFunc = handler;
+        if (handler != Handler::Disable) {
+            bits::add(*maskReg, bits::Bit5);
+        } else {
+            bits::add(*maskReg, ~bits::Bit5);
+        }
+    }
+};
+
+/**
+ * Hardware Timer2 8 bits
+ * with asynchronous operation from
+ * a 32.768kHz watch crystal (TOSC1/TOSC2)
+ */
+struct Timer2Object
+{
+    /**
+     * Timer specific interrupt handler
+     */
+    typedef isr::Handler<Timer2Object> Handler;
+
+    /**
+     * A and B control, counter, A and B compare, 
+     * mask, flag and asynchronous status registers
+     */
+    const bytePtr controlAReg;
+    const bytePtr controlBReg;
+    const bytePtr counterReg;
+    const bytePtr compareAReg;
+    const bytePtr compareBReg;
+    const bytePtr maskReg;
+    const bytePtr flagReg;
+    const bytePtr asyncReg;
+
+    /**
+     * User defined
+     * interrupt routines
+     */
+    Handler::type onMatchAFunc;
+    Handler::type onMatchBFunc;
+    Handler::type onOverflowFunc;
+
+    /**
+     * Configure given timer wave and top counter mode
+     */
+    inline void setCounterMode(TimerCounterMode mode) const
+    {
+        if (mode == WaveNormalTopNormal) {
+            bits::add(*controlBReg, ~bits::Bit3);
+            bits::add(*controlAReg, ~bits::Bit1, ~bits::Bit0);
+        } else if (mode == WaveNormalTopCompareA) {
+            bits::add(*controlBReg, ~bits::Bit3);
+            bits::add(*controlAReg, bits::Bit1, ~bits::Bit0);
+        } else if (mode == WavePwmTopNormal) {
+            bits::add(*controlBReg, ~bits::Bit3);
+            bits::add(*controlAReg, bits::Bit1, bits::Bit0);
+        } else if (mode == WavePwmTopCompareA) {
+            bits::add(*controlBReg, bits::Bit3);
+            bits::add(*controlAReg, bits::Bit1, bits::Bit0);
+        } else if (mode == WavePwm8Bits) {
+            bits::add(*controlBReg, ~bits::Bit3);
+            bits::add(*controlAReg, bits::Bit1, bits::Bit0);
+        } else if (mode == WavePhasePwmTopNormal) {
+            bits::add(*controlBReg, ~bits::Bit3);
+            bits::add(*controlAReg, ~bits::Bit1, bits::Bit0);
+        } else if (mode == WavePhasePwmTopCompareA) {
+            bits::add(*controlBReg, bits::Bit3);
+            bits::add(*controlAReg, ~bits::Bit1, bits::Bit0);
+        } else if (mode == WavePhasePwm8Bits) {
+            bits::add(*controlBReg, ~bits::Bit3);
+            bits::add(*controlAReg, ~bits::Bit1, bits::Bit0);
+        }
+    }
+
+    /**
+     * Configure output pin mode for Pin A and B
+     * with given mode
+     */
+    inline void setPinModeA(TimerPinMode mode) const
+    {
+        if (mode == PinDisable) {
+            bits::add(*controlAReg, ~bits::Bit7, ~bits::Bit6);
+        } else if (mode == PinToggle) {
+            bits::add(*controlAReg, ~bits::Bit7, bits::Bit6);
+        } else if (mode == PinSet) {
+            bits::add(*controlAReg, bits::Bit7, bits::Bit6);
+        } else if (mode == PinClear) {
+            bits::add(*controlAReg, bits::Bit7, ~bits::Bit6);
+        } else if (mode == PinPwm) {
+            bits::add(*controlAReg, bits::Bit7, ~bits::Bit6);
+        } else if (mode == PinPwmInv) {
+            bits::add(*controlAReg, bits::Bit7, bits::Bit6);
+        }
+    }
+    inline void setPinModeB(TimerPinMode mode) const
+    {
+        if (mode == PinDisable) {
+            bits::add(*controlAReg, ~bits::Bit5, ~bits::Bit4);
+        } else if (mode == PinToggle) {
+            bits::add(*controlAReg, ~bits::Bit5, bits::Bit4);
+        } else if (mode == PinSet) {
+            bits::add(*controlAReg, bits::Bit5, bits::Bit4);
+        } else if (mode == PinClear) {
+            bits::add(*controlAReg, bits::Bit5, ~bits::Bit4);
+        } else if (mode == PinPwm) {
+            bits::add(*controlAReg, bits::Bit5, ~bits::Bit4);
+        } else if (mode == PinPwmInv) {
+            bits::add(*controlAReg, bits::Bit5, bits::Bit4);
+        }
+    }
+
+    /**
+     * Configure given clock divider
+     * (External clocks are not available,
+     * see asynchronous mode)
+     */
+    inline void setClock(TimerClock clock) const
+    {
+        if (clock == ClockStop) {
+            bits::add(*controlBReg, ~bits::Bit2, ~bits::Bit1, ~bits::Bit0);
+        } else if (clock == ClockDiv1) {
+            bits::add(*controlBReg, ~bits::Bit2, ~bits::Bit1, bits::Bit0);
+        } else if (clock == ClockDiv8) {
+            bits::add(*controlBReg, ~bits::Bit2, bits::Bit1, ~bits::Bit0);
+        } else if (clock == ClockDiv32) {
+            bits::add(*controlBReg, ~bits::Bit2, bits::Bit1, bits::Bit0);
+        } else if (clock == ClockDiv64) {
+            bits::add(*controlBReg, bits::Bit2, ~bits::Bit1, ~bits::Bit0);
+        } else if (clock == ClockDiv128) {
+            bits::add(*controlBReg, bits::Bit2, ~bits::Bit1, bits::Bit0);
+        } else if (clock == ClockDiv256) {
+            bits::add(*controlBReg, bits::Bit2, bits::Bit1, ~bits::Bit0);
+        } else if (clock == ClockDiv1024) {
+            bits::add(*controlBReg, bits::Bit2, bits::Bit1, bits::Bit0);
+        }
+    }
+
+    /**
+     * Clock the timer from the TOSC1/TOSC2 crystal
+     * oscillator (or external clock on TOSC1) or from
+     * the cpu clock. Counter, compare and control registers
+     * may be corrupted by the switch: interrupts have to be
+     * disabled and registers written again afterward
+     * (then wait for update completion).
+     */
+    inline void setAsynchronous(logic isAsync, 
+        logic isExternalClock = False) const
+    {
+        if (isAsync == True) {
+            bits::set(*asyncReg, bits::Bit6, isExternalClock);
+            bits::add(*asyncReg, bits::Bit5);
+        } else {
+            bits::add(*asyncReg, ~bits::Bit5, ~bits::Bit6);
+        }
+    }
+
+    /**
+     * Return true while a write to counter, compare A/B
+     * or control A/B register is not yet transfered to the
+     * asynchronous clock domain (asynchronous mode only)
+     */
+    inline logic isUpdateBusy() const
+    {
+        return logic_cast((byte)(*asyncReg & 0b00011111));
+    }
+
+    /**
+     * Wait until all pending register writes are
+     * transfered to the asynchronous clock domain
+     */
+    inline void waitUpdate() const
+    {
+        while (isUpdateBusy());
+    }
+
+    /**
+     * Rewrite the control A register and wait for its
+     * transfer. Guarantees that at least one asynchronous
+     * clock cycle has elapsed (required before reading the
+     * counter or entering sleep after a Timer2 wake up).
+     */
+    inline void synchronize() const
+    {
+        *controlAReg = *controlAReg;
+        while (bits::get(*asyncReg, bits::Bit1));
+    }
+
+    /**
+     * Configure compare match mode (WaveNormalTopCompareA)
+     * with given solved period. Control registers are each
+     * written once (see TimerPeriod).
+     * Return false and leave the timer unchanged if the
+     * setting was not solved for this timer width and
+     * prescaler set.
+     */
+    inline logic setPeriod(const TimerSetting& setting) const
+    {
+        if (
+            setting.width != Width8Bits || 
+            setting.prescalers != PrescalersTimer2
+        ) {
+            return False;
+        }
+        *compareAReg = setting.top;
+        *controlAReg = (*controlAReg & 0b11111100) | 0b00000010;
+        *controlBReg = (*controlBReg & 0b11110000) | 
+            timerClockBits(setting.clock, PrescalersTimer2);
+        return True;
+    }
+
+    /**
+     * Read and write to counter register
+     */
+    inline byte readCounter() const
+    {
+        return *counterReg;
+    }
+    inline void writeCounter(byte value) const
+    {
+        *counterReg = value;
+    }
+    
+    /**
+     * Read and write to counter compare 
+     * register A and B
+     */
+    inline byte readCompareA() const
+    {
+        return *compareAReg;
+    }
+    inline void writeCompareA(byte value) const
+    {
+        *compareAReg = value;
+    }
+    inline byte readCompareB() const
+    {
+        return *compareBReg;
+    }
+    inline void writeCompareB(byte value) const
+    {
+        *compareBReg = value;
+    }
+
     /**
      * Return true when a compare match A, B 
      * or overflow has occured
@@ -459,18 +1137,20 @@ struct Timer1Object
     /**
      * Manually clear compare match A, B 
      * and overflow flags
+     * (Flags are cleared by writing one, so only
+     * the given flag is written)
      */
     inline void clearMatchA() const
     {
-        bits::add(*flagReg, bits::Bit1);
+        bits::assign(*flagReg, bits::Bit1);
     }
     inline void clearMatchB() const
     {
-        bits::add(*flagReg, bits::Bit2);
+        bits::assign(*flagReg, bits::Bit2);
     }
     inline void clearOverflow() const
     {
-        bits::add(*flagReg, bits::Bit0);
+        bits::assign(*flagReg, bits::Bit0);
     }
     
     /**
@@ -527,7 +1207,12 @@ Timer0Object Timer0 = {
 Timer1Object Timer1 = {
     &TCCR1A, &TCCR1B, &TCCR1C, &TCNT1, &OCR1A, &OCR1B, &ICR1, &TIMSK1, &TIFR1,
     Timer1Object::Handler::Disable, Timer1Object::Handler::Disable, 
-    Timer1Object::Handler::Disable 
+    Timer1Object::Handler::Disable, Timer1Object::Handler::Disable 
+};
+Timer2Object Timer2 = {
+    &TCCR2A, &TCCR2B, &TCNT2, &OCR2A, &OCR2B, &TIMSK2, &TIFR2, &ASSR,
+    Timer2Object::Handler::Disable, Timer2Object::Handler::Disable, 
+    Timer2Object::Handler::Disable 
 };
 
 /**
@@ -535,40 +1220,74 @@ Timer1Object Timer1 = {
  */
 ISR(TIMER0_COMPA_vect)
 {
+    ISR_PROBE(isr::VectorTimer0MatchA);
     if (Timer0.onMatchAFunc != Timer0Object::Handler::Disable) {
         Timer0.onMatchAFunc(Timer0);
     }
 }
 ISR(TIMER0_COMPB_vect)
 {
+    ISR_PROBE(isr::VectorTimer0MatchB);
     if (Timer0.onMatchBFunc != Timer0Object::Handler::Disable) {
         Timer0.onMatchBFunc(Timer0);
     }
 }
 ISR(TIMER0_OVF_vect)
 {
+    ISR_PROBE(isr::VectorTimer0Overflow);
     if (Timer0.onOverflowFunc != Timer0Object::Handler::Disable) {
         Timer0.onOverflowFunc(Timer0);
     }
 }
 ISR(TIMER1_COMPA_vect)
 {
+    ISR_PROBE(isr::VectorTimer1MatchA);
     if (Timer1.onMatchAFunc != Timer1Object::Handler::Disable) {
         Timer1.onMatchAFunc(Timer1);
     }
 }
 ISR(TIMER1_COMPB_vect)
 {
+    ISR_PROBE(isr::VectorTimer1MatchB);
     if (Timer1.onMatchBFunc != Timer1Object::Handler::Disable) {
         Timer1.onMatchBFunc(Timer1);
     }
 }
 ISR(TIMER1_OVF_vect)
 {
+    ISR_PROBE(isr::VectorTimer1Overflow);
     if (Timer1.onOverflowFunc != Timer1Object::Handler::Disable) {
         Timer1.onOverflowFunc(Timer1);
     }
 }
+ISR(TIMER1_CAPT_vect)
+{
+    ISR_PROBE(isr::VectorTimer1Capture);
+    if (Timer1.onCaptureFunc != Timer1Object::Handler::Disable) {
+        Timer1.onCaptureFunc(Timer1);
+    }
+}
+ISR(TIMER2_COMPA_vect)
+{
+    ISR_PROBE(isr::VectorTimer2MatchA);
+    if (Timer2.onMatchAFunc != Timer2Object::Handler::Disable) {
+        Timer2.onMatchAFunc(Timer2);
+    }
+}
+ISR(TIMER2_COMPB_vect)
+{
+    ISR_PROBE(isr::VectorTimer2MatchB);
+    if (Timer2.onMatchBFunc != Timer2Object::Handler::Disable) {
+        Timer2.onMatchBFunc(Timer2);
+    }
+}
+ISR(TIMER2_OVF_vect)
+{
+    ISR_PROBE(isr::VectorTimer2Overflow);
+    if (Timer2.onOverflowFunc != Timer2Object::Handler::Disable) {
+        Timer2.onOverflowFunc(Timer2);
+    }
+}
 
 }
 
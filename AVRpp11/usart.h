@@ -301,18 +301,21 @@ UsartObject Usart0 = {
  */
 ISR(USART_RX_vect)
 {
+    ISR_PROBE(isr::VectorUsartReadReady);
     if (Usart0.onReadReadyFunc != UsartObject::Handler::Disable) {
         Usart0.onReadReadyFunc(Usart0);
     }
 }
 ISR(USART_UDRE_vect)
 {
+    ISR_PROBE(isr::VectorUsartWriteReady);
     if (Usart0.onWriteReadyFunc != UsartObject::Handler::Disable) {
         Usart0.onWriteReadyFunc(Usart0);
     }
 }
 ISR(USART_TX_vect)
 {
+    ISR_PROBE(isr::VectorUsartDataSent);
     if (Usart0.onDataSentFunc != UsartObject::Handler::Disable) {
         Usart0.onDataSentFunc(Usart0);
     }
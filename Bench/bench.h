@@ -0,0 +1,133 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+/**
+ * Micro benchmark harness for simavr
+ *
+ * Each firmware measures code blocks in cpu cycles
+ * with Timer1 free running without prescaler and writes
+ * "BENCH name cycles" lines to the simavr console register
+ * (GPIOR0). The firmware ends with end(), which sleeps
+ * with interrupts disabled so that simavr exits.
+ * Timer1 is owned by the harness, measured blocks have
+ * to be shorter than 65536 cycles.
+ * Run with Tools/bench.sh (make bench).
+ */
+#include <avr/sleep.h>
+#include <simavr/avr/avr_mcu_section.h>
+
+#include "../AVRpp11/mapping/arduino.h"
+#include "../AVRpp11/avrpp11.h"
+
+/**
+ * Simavr target description
+ * and console register
+ */
+AVR_MCU(F_CPU, "atmega328p");
+AVR_MCU_SIMAVR_CONSOLE(&GPIOR0);
+
+namespace bench {
+
+/**
+ * Cycles of an empty measure
+ */
+word overhead = 0;
+
+/**
+ * Return Timer1 counter between
+ * compiler barriers
+ */
+inline word now()
+{
+    __asm__ __volatile__ ("" ::: "memory");
+    word counter = TCNT1;
+    __asm__ __volatile__ ("" ::: "memory");
+    return counter;
+}
+
+/**
+ * Write given character, string
+ * or number to the simavr console
+ */
+inline void write(char c)
+{
+    GPIOR0 = c;
+}
+inline void write(const char* str)
+{
+    while (*str != '\0') {
+        write(*str);
+        str++;
+    }
+}
+inline void write(uint32_t val)
+{
+    char str[11];
+    byte index = sizeof(str) - 1;
+    str[index] = '\0';
+    do {
+        index--;
+        str[index] = '0' + val%10;
+        val /= 10;
+    } while (val != 0);
+    write(&str[index]);
+}
+
+/**
+ * Print a result line
+ */
+inline void report(const char* name, uint32_t cycles)
+{
+    write("BENCH ");
+    write(name);
+    write(' ');
+    write(cycles);
+    write('\n');
+}
+
+/**
+ * Start Timer1 and calibrate
+ * the measure overhead
+ */
+inline void init()
+{
+    isr::disable();
+    timer::Timer1.setClock(timer::ClockStop);
+    timer::Timer1.setCounterMode(timer::WaveNormalTopNormal);
+    timer::Timer1.setPinModeA(timer::PinDisable);
+    timer::Timer1.setPinModeB(timer::PinDisable);
+    timer::Timer1.writeCounter(0);
+    timer::Timer1.setClock(timer::ClockDiv1);
+    isr::enable();
+    word start = now();
+    word stop = now();
+    overhead = stop - start;
+}
+
+/**
+ * Stop the simulation
+ */
+inline void end()
+{
+    isr::disable();
+    set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+    sleep_enable();
+    sleep_cpu();
+}
+
+}
+
+/**
+ * Measure given statement cycles
+ * and report them with given name
+ */
+#define BENCH(name, statement) \
+    do { \
+        word benchStart = bench::now(); \
+        statement; \
+        word benchStop = bench::now(); \
+        bench::report(name, \
+            (word)(benchStop - benchStart - bench::overhead)); \
+    } while (0)
+
+#endif
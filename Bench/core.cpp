@@ -0,0 +1,26 @@
+#include "bench.h"
+
+/**
+ * Bits manipulation and Gpio access
+ */
+int main()
+{
+    bench::init();
+    volatile logic value;
+
+    BENCH("bits::assign", bits::assign(DDRB, bits::Bit2));
+    BENCH("bits::add", bits::add(DDRB, bits::Bit2));
+    BENCH("bits::add4", bits::add(DDRB,
+        ~bits::Bit2, bits::Bit1, bits::Bit3, ~bits::Bit4));
+    BENCH("bits::get", value = bits::get(PINB, bits::Bit1));
+    BENCH("bits::toggle", bits::toggle(PORTB, bits::Bit2));
+
+    BENCH("GpioObject::setMode", gpio::D7.setMode(gpio::Output));
+    BENCH("GpioObject::write", gpio::D7.write(High));
+    BENCH("GpioObject::toggle", gpio::D7.toggle());
+    BENCH("GpioObject::read", value = gpio::D7.read());
+
+    (void)value;
+    bench::end();
+    return 0;
+}
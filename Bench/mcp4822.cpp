@@ -0,0 +1,36 @@
+#define AVRPP11_ISR_STATS
+#include "bench.h"
+#include <util/delay.h>
+#include "../AVRpp11/lib/MCP4822.hpp"
+
+/**
+ * MCP4822 polled and interrupt transfers
+ */
+int main()
+{
+    bench::init();
+    MCP4822::init(gpio::D7);
+
+    BENCH("MCP4822::writeChannel.polled",
+        MCP4822::writeChannel(MCP4822::ChannelA, 2048,
+        MCP4822::TransferPolled));
+    BENCH("MCP4822::writeBoth.polled",
+        MCP4822::writeBoth(1024, 3072, MCP4822::TransferPolled));
+
+    //Interrupt transfers return before completion,
+    //the handler is measured by the interrupt statistics
+    isr::resetStats();
+    BENCH("MCP4822::writeChannel.interrupt",
+        MCP4822::writeChannel(MCP4822::ChannelA, 2048));
+    _delay_us(20);
+    BENCH("MCP4822::writeBoth.interrupt",
+        MCP4822::writeBoth(1024, 3072));
+    _delay_us(20);
+    isr::VectorStats stats = isr::getStats(isr::VectorSpi);
+    bench::report("MCP4822::isrHandler.count", stats.count);
+    bench::report("MCP4822::isrHandler.max", stats.max);
+    bench::report("MCP4822::isrHandler.total", stats.total);
+
+    bench::end();
+    return 0;
+}
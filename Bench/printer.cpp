@@ -0,0 +1,28 @@
+#include "bench.h"
+#include "../AVRpp11/lib/Printer.hpp"
+
+/**
+ * Printer formatting and queueing
+ * (output flushed between measures)
+ */
+int main()
+{
+    bench::init();
+    Printer::init(usart::BaudRate115200);
+
+    BENCH("Printer::write(char)", Printer::write('a'));
+    Printer::waitFlush();
+    BENCH("Printer::write(str)", Printer::write("bench"));
+    Printer::waitFlush();
+    BENCH("Printer::write(byte)", Printer::write((byte)255));
+    Printer::waitFlush();
+    BENCH("Printer::write(word)", Printer::write((word)65535));
+    Printer::waitFlush();
+    BENCH("Printer::write(word)small", Printer::write((word)7));
+    Printer::waitFlush();
+    BENCH("Printer::write(uint32_t)", Printer::write((uint32_t)4000000000UL));
+    Printer::waitFlush();
+
+    bench::end();
+    return 0;
+}
@@ -0,0 +1,27 @@
+#define AVRPP11_ISR_STATS
+#include "bench.h"
+#include "../AVRpp11/lib/Printer.hpp"
+
+/**
+ * Usart byte interrupt handler
+ * (Printer write ready handler measured
+ * by the interrupt statistics)
+ */
+int main()
+{
+    bench::init();
+    Printer::init(usart::BaudRate115200);
+    isr::resetStats();
+
+    Printer::write("0123456789");
+    Printer::waitFlush();
+
+    isr::VectorStats stats = isr::getStats(isr::VectorUsartWriteReady);
+    bench::report("Usart0WriteReady.count", stats.count);
+    bench::report("Usart0WriteReady.max", stats.max);
+    bench::report("Usart0WriteReady.avg",
+        stats.count == 0 ? 0 : stats.total/stats.count);
+
+    bench::end();
+    return 0;
+}
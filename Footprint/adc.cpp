@@ -0,0 +1,16 @@
+#include "footprint.h"
+
+/**
+ * Adc single conversion
+ */
+int main()
+{
+    adc::Adc.setReference(adc::ReferenceSupply);
+    adc::Adc.setPrescaler(adc::PrescalerDiv128);
+    adc::Adc.setInput(adc::PinAdc0);
+    adc::Adc.enable();
+    adc::Adc.startConversion();
+    while (adc::Adc.isConverting());
+    sink = adc::Adc.readValue();
+    return 0;
+}
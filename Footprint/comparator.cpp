@@ -0,0 +1,23 @@
+#include "footprint.h"
+
+/**
+ * Analog comparator with interrupt handler
+ */
+void onTrigger(HandlerArg(comparator::AnalogComparator) c)
+{
+    sink = c.read();
+}
+
+int main()
+{
+    comparator::AnalogComparator.setPositiveInput(
+        comparator::PositiveBandgap);
+    comparator::AnalogComparator.setNegativeInput(
+        comparator::NegativePinAdc0);
+    comparator::AnalogComparator.setEdge(comparator::EdgeRising);
+    comparator::AnalogComparator.onTrigger(onTrigger);
+    comparator::AnalogComparator.enable();
+    isr::enable();
+    while (true);
+    return 0;
+}
@@ -0,0 +1,15 @@
+#include "footprint.h"
+#include "../AVRpp11/lib/Dds.hpp"
+
+/**
+ * Two channels sine synthesis on MCP4822
+ */
+int main()
+{
+    MCP4822::init(gpio::OC1A);
+    Dds::setFrequency(MCP4822::ChannelA, 440000);
+    Dds::setFrequency(MCP4822::ChannelB, 880000);
+    Dds::start(20000);
+    while (true);
+    return 0;
+}
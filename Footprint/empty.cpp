@@ -0,0 +1,9 @@
+#include "footprint.h"
+
+/**
+ * Library included, nothing used
+ */
+int main()
+{
+    return 0;
+}
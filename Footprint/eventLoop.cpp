@@ -0,0 +1,18 @@
+#include "footprint.h"
+#include "../AVRpp11/lib/EventLoop.hpp"
+
+/**
+ * Event loop with one posted work item
+ */
+void work(word data)
+{
+    sink = data;
+}
+
+int main()
+{
+    SystemClock::init();
+    EventLoop::post(work, 1);
+    EventLoop::run();
+    return 0;
+}
@@ -0,0 +1,21 @@
+#ifndef FOOTPRINT_H
+#define FOOTPRINT_H
+
+/**
+ * Common includes of the footprint firmwares
+ *
+ * Each firmware uses a single peripheral or
+ * driver feature, its flash and RAM sizes minus the
+ * empty firmware ones are the feature footprint.
+ * Built and measured by Tools/footprint.sh
+ * (make footprint).
+ */
+#include "../AVRpp11/mapping/arduino.h"
+#include "../AVRpp11/avrpp11.h"
+
+/**
+ * Sink keeping read values alive
+ */
+volatile word sink;
+
+#endif
@@ -0,0 +1,14 @@
+#include "footprint.h"
+
+/**
+ * Gpio write, toggle and read
+ */
+int main()
+{
+    gpio::D13.setMode(gpio::Output);
+    gpio::D13.write(High);
+    gpio::D13.toggle();
+    gpio::D7.setMode(gpio::InputPullUp);
+    sink = gpio::D7.read();
+    return 0;
+}
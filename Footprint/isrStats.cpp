@@ -0,0 +1,12 @@
+#define AVRPP11_ISR_STATS
+#include "footprint.h"
+
+/**
+ * Interrupt statistics instrumentation
+ * (all vectors, nothing else used)
+ */
+int main()
+{
+    sink = isr::getStats(isr::VectorSpi).max;
+    return 0;
+}
@@ -0,0 +1,13 @@
+#include "footprint.h"
+#include "../AVRpp11/lib/MCP4822.hpp"
+
+/**
+ * MCP4822 interrupt transfer
+ */
+int main()
+{
+    MCP4822::init(gpio::D7);
+    MCP4822::writeBoth(1024, 2048);
+    while (true);
+    return 0;
+}
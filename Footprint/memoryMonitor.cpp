@@ -0,0 +1,13 @@
+#include "footprint.h"
+#include "../AVRpp11/lib/MemoryMonitor.hpp"
+
+/**
+ * Memory check and report
+ */
+int main()
+{
+    Printer::init(usart::BaudRate9600);
+    MemoryMonitor::check();
+    MemoryMonitor::report();
+    return 0;
+}
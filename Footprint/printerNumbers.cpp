@@ -0,0 +1,17 @@
+#include "footprint.h"
+#include "../AVRpp11/lib/Printer.hpp"
+
+/**
+ * Printer number formatting
+ * (digit macros and 32 bits table)
+ */
+int main()
+{
+    Printer::init(usart::BaudRate9600);
+    Printer::write((byte)sink);
+    Printer::write((word)sink);
+    Printer::write((sword)sink);
+    Printer::write((uint32_t)sink << 8);
+    Printer::waitFlush();
+    return 0;
+}
@@ -0,0 +1,14 @@
+#include "footprint.h"
+#include "../AVRpp11/lib/Printer.hpp"
+
+/**
+ * Printer string output
+ */
+int main()
+{
+    Printer::init(usart::BaudRate9600);
+    Printer::write("footprint");
+    Printer::endl();
+    Printer::waitFlush();
+    return 0;
+}
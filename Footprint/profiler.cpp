@@ -0,0 +1,18 @@
+#include "footprint.h"
+#include "../AVRpp11/lib/Profiler.hpp"
+
+/**
+ * One profiling zone and report
+ */
+int main()
+{
+    SystemClock::init();
+    Printer::init(usart::BaudRate9600);
+    Profiler::init();
+    {
+        PROFILE_ZONE(0);
+        sink++;
+    }
+    Profiler::report();
+    return 0;
+}
@@ -0,0 +1,15 @@
+#include "footprint.h"
+#include "../AVRpp11/lib/Servo.hpp"
+
+/**
+ * One servo
+ */
+int main()
+{
+    Servo::init();
+    byte id = Servo::attach(gpio::D9);
+    Servo::setAngle(id, 90);
+    Servo::commit();
+    while (true);
+    return 0;
+}
@@ -0,0 +1,15 @@
+#include "footprint.h"
+#include "../AVRpp11/lib/SoftPwm.hpp"
+
+/**
+ * One software Pwm channel
+ */
+int main()
+{
+    SoftPwm::init();
+    SoftPwm::attach(gpio::D13);
+    SoftPwm::setDuty(gpio::D13, 64);
+    SoftPwm::commit();
+    while (true);
+    return 0;
+}
@@ -0,0 +1,20 @@
+#include "footprint.h"
+#include "../AVRpp11/lib/SoftTimer.hpp"
+
+/**
+ * One periodic deferred soft timer
+ */
+void onTimer()
+{
+    sink++;
+}
+
+int main()
+{
+    SystemClock::init();
+    SoftTimer::start(onTimer, 16000, 16000, SoftTimer::ContextDeferred);
+    while (true) {
+        SoftTimer::dispatch();
+    }
+    return 0;
+}
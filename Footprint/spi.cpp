@@ -0,0 +1,15 @@
+#include "footprint.h"
+
+/**
+ * Spi master polled transfer
+ */
+int main()
+{
+    gpio::SS.setMode(gpio::Output);
+    spi::Spi.setMode(spi::Master);
+    spi::Spi.setClockDivider(spi::ClockDiv2);
+    spi::Spi.write(0x55);
+    while (!spi::Spi.isTransfertComplet());
+    sink = spi::Spi.read();
+    return 0;
+}
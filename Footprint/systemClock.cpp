@@ -0,0 +1,13 @@
+#include "footprint.h"
+#include "../AVRpp11/lib/SystemClock.hpp"
+
+/**
+ * SystemClock reads
+ */
+int main()
+{
+    SystemClock::init();
+    sink = SystemClock::micros();
+    sink = SystemClock::millis();
+    return 0;
+}
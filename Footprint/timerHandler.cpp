@@ -0,0 +1,19 @@
+#include "footprint.h"
+
+/**
+ * Timer overflow with a function handler
+ */
+void onOverflow(HandlerArg(timer::Timer0) t)
+{
+    sink++;
+}
+
+int main()
+{
+    timer::Timer0.setCounterMode(timer::WaveNormalTopNormal);
+    timer::Timer0.onOverflow(onOverflow);
+    timer::Timer0.setClock(timer::ClockDiv64);
+    isr::enable();
+    while (true);
+    return 0;
+}
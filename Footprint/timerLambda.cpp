@@ -0,0 +1,16 @@
+#include "footprint.h"
+
+/**
+ * Timer overflow with a lambda handler
+ */
+int main()
+{
+    timer::Timer0.setCounterMode(timer::WaveNormalTopNormal);
+    timer::Timer0.onOverflow([](HandlerArg(timer::Timer0) t) {
+        sink++;
+    });
+    timer::Timer0.setClock(timer::ClockDiv64);
+    isr::enable();
+    while (true);
+    return 0;
+}
@@ -0,0 +1,14 @@
+#include "footprint.h"
+#include "../AVRpp11/lib/TLC5940.hpp"
+
+/**
+ * One TLC5940 with polled upload
+ */
+int main()
+{
+    TLC5940<1>::init();
+    TLC5940<1>::set(0, 4095);
+    TLC5940<1>::update();
+    while (true);
+    return 0;
+}
@@ -0,0 +1,18 @@
+#include "footprint.h"
+#include "../AVRpp11/lib/Trace.hpp"
+
+/**
+ * Event trace with trigger and dump
+ */
+int main()
+{
+    SystemClock::init();
+    Trace::clear();
+    Trace::setTrigger(1, 8);
+    TRACE(0, sink);
+    TRACE(1, sink);
+    if (Trace::isFrozen()) {
+        Trace::dump();
+    }
+    return 0;
+}
@@ -0,0 +1,15 @@
+#include "footprint.h"
+
+/**
+ * Usart polled write
+ */
+int main()
+{
+    usart::Usart0.setMode(usart::Write);
+    usart::Usart0.setBitStop(usart::BitStop1);
+    usart::Usart0.setParity(usart::ParityDisable);
+    usart::Usart0.setBaudrate(usart::BaudRate9600);
+    while (!usart::Usart0.isWriteReady());
+    usart::Usart0.write('a');
+    return 0;
+}
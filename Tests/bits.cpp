@@ -0,0 +1,44 @@
+#include "test.h"
+
+/**
+ * Bit values and register manipulation
+ */
+int main()
+{
+    host::reset();
+
+    CHECK(bits::value<byte>(bits::Bit2) == 0b00000100);
+    CHECK(bits::value<byte>(bits::Bit1, bits::Bit2) == 0b00000110);
+    CHECK(bits::value<byte>(bits::Bit1, ~bits::Bit2) == 0b00000010);
+    CHECK(bits::value<byte>(~bits::Bit2) == 0);
+    CHECK(bits::value<word>(bits::Bit7, bits::Bit0) == 0b10000001);
+
+    CHECK(bits::valueInv<byte>(bits::Bit2) == 0);
+    CHECK(bits::valueInv<byte>(~bits::Bit2) == 0b00000100);
+    CHECK(bits::valueInv<byte>(~bits::Bit1, ~bits::Bit2) == 0b00000110);
+    CHECK(bits::valueInv<byte>(bits::Bit1, ~bits::Bit2) == 0b00000100);
+
+    DDRB = 0xFF;
+    bits::assign(DDRB, bits::Bit2, bits::Bit3);
+    CHECK(DDRB == 0b00001100);
+    bits::add(DDRB, bits::Bit0, ~bits::Bit3);
+    CHECK(DDRB == 0b00000101);
+    CHECK(bits::get(DDRB, bits::Bit2) == True);
+    CHECK(!bits::get(DDRB, bits::Bit3));
+    bits::set(DDRB, bits::Bit7, High);
+    CHECK(DDRB == 0b10000101);
+    bits::toggle(DDRB, bits::Bit7);
+    CHECK(DDRB == 0b00000101);
+
+    gpio::D13.setMode(gpio::Output);
+    gpio::D13.write(High);
+    CHECK((DDRB & 0b00100000) != 0);
+    CHECK((PORTB & 0b00100000) != 0);
+    //Toggle writes one to the input register
+    //(the port toggle is done by the hardware)
+    PINB = 0;
+    gpio::D13.toggle();
+    CHECK(PINB == 0b00100000);
+
+    return test::end("bits");
+}
@@ -0,0 +1,100 @@
+#include "test.h"
+#include "../AVRpp11/lib/Dds.hpp"
+
+/**
+ * Return the exact phase increment
+ * of given frequency and sample rate
+ */
+uint32_t referenceStep(uint32_t milliHertz, uint32_t sampleRate)
+{
+    return ((unsigned long long)milliHertz << 32)/
+        ((unsigned long long)sampleRate*1000);
+}
+
+/**
+ * Run the stream handler for given number of
+ * samples and return the number of channel B
+ * square wave rising edges (low byte of the last
+ * sent frame goes from 0x00 to 0xFF)
+ */
+uint32_t countCycles(uint32_t sampleCount)
+{
+    uint32_t count = 0;
+    byte previous = 0xFF;
+    for (uint32_t i=0;i<sampleCount;i++) {
+        host::raise(TIMER1_COMPA_vect);
+        if (previous == 0x00 && SPDR == 0xFF) {
+            count++;
+        }
+        previous = SPDR;
+    }
+    return count;
+}
+
+/**
+ * Dds frequency accuracy and sample transfer
+ */
+int main()
+{
+    host::reset();
+    sei();
+
+    //32 bits phase increment against 64 bits
+    //reference at several sample rates
+    const uint32_t rates[] = {8000, 40000, 50000, 100000};
+    const uint32_t frequencies[] = {1, 1000, 440000, 1000000,
+        3999999, 19999000};
+    int mismatchCount = 0;
+    for (uint32_t rate : rates) {
+        for (uint32_t frequency : frequencies) {
+            if (frequency > rate*500) {
+                continue;
+            }
+            if (Dds::stepFromFrequency(frequency, rate) !=
+                referenceStep(frequency, rate)
+            ) {
+                mismatchCount++;
+            }
+        }
+    }
+    CHECK(mismatchCount == 0);
+
+    //Generated frequency within the resolution
+    uint32_t step = Dds::stepFromFrequency(1000000, 40000);
+    double actual = (double)step*40000/4294967296.0;
+    CHECK(actual <= 1000.0 && 1000.0 - actual < 0.00001);
+
+    //Stream at 40kHz (Timer1 period of 400 cycles)
+    MCP4822::init(gpio::OC1A);
+    CHECK(Dds::start(40000) == 40000);
+    CHECK(Dds::getResolutionMicroHertz() == 9);
+    CHECK(ICR1 == 399);
+
+    //Handler sends both frames (channel B last)
+    //without touching the timer owned LDAC pin
+    //(polled transfer flag is always set on host)
+    Dds::setWaveform(MCP4822::ChannelB, Dds::WaveSawtooth);
+    Dds::setPhase(MCP4822::ChannelB, 0xABC0);
+    byte portB = PORTB;
+    SPSR |= 0b10000000;
+    host::raise(TIMER1_COMPA_vect);
+    CHECK(SPDR == 0xBC);
+    CHECK(gpio::SS.readOutput() == High);
+    CHECK((PORTB & 0b00000010) == (portB & 0b00000010));
+
+    //Output frequency: square wave periods
+    //over one and two seconds of samples
+    Dds::setWaveform(MCP4822::ChannelB, Dds::WaveSquare);
+    Dds::setPhase(MCP4822::ChannelB, 0);
+    Dds::setFrequency(MCP4822::ChannelB, 1000000);
+    CHECK(countCycles(40000) == 1000);
+    Dds::setPhase(MCP4822::ChannelB, 0);
+    Dds::setFrequency(MCP4822::ChannelB, 440000);
+    CHECK(countCycles(40000) == 440);
+    Dds::setPhase(MCP4822::ChannelB, 0);
+    Dds::setFrequency(MCP4822::ChannelB, 1234500);
+    uint32_t count = countCycles(80000);
+    CHECK(count >= 2468 && count <= 2469);
+
+    return test::end("dds");
+}
@@ -0,0 +1,63 @@
+#include "test.h"
+#include "../AVRpp11/lib/EventLoop.hpp"
+
+/**
+ * Number of sleeps (model steps),
+ * idle hook and work calls
+ */
+int sleepCount = 0;
+int idleCount = 0;
+int workCount = 0;
+
+void sleepModel()
+{
+    sleepCount++;
+}
+
+void idleHook()
+{
+    idleCount++;
+}
+
+void work(word data)
+{
+    workCount++;
+}
+
+/**
+ * EventLoop dispatch and idle sleep
+ */
+int main()
+{
+    host::reset();
+    host::addModel(sleepModel);
+    SystemClock::init();
+    sei();
+    EventLoop::onIdle(idleHook);
+
+    //Empty queue: idle hook then sleep
+    CHECK(!EventLoop::runOnce());
+    EventLoop::idle();
+    CHECK(idleCount == 1);
+    CHECK(sleepCount == 1);
+    CHECK((SMCR & 0x01) == 0);
+
+    //Pending work item: no sleep
+    CHECK(EventLoop::post(work, 1) == True);
+    EventLoop::idle();
+    CHECK(sleepCount == 1);
+    CHECK(EventLoop::runOnce() == True);
+    CHECK(workCount == 1);
+    CHECK(!EventLoop::isPending());
+
+    //Sleep disabled: busy loop
+    EventLoop::disableSleep();
+    EventLoop::idle();
+    CHECK(idleCount == 3);
+    CHECK(sleepCount == 1);
+    EventLoop::setSleepMode(SLEEP_MODE_IDLE);
+    EventLoop::idle();
+    CHECK(sleepCount == 2);
+
+    return test::end("eventLoop");
+}
@@ -0,0 +1,68 @@
+#include "test.h"
+#include "../AVRpp11/lib/InputCapture.hpp"
+
+/**
+ * Capture given counter value on the
+ * currently selected edge (toggled by the
+ * handler in EdgeBoth mode)
+ */
+void capture(word counter)
+{
+    ICR1 = counter;
+    host::raise(TIMER1_CAPT_vect);
+}
+
+/**
+ * Start capturing both edges (flags written
+ * to one by start() are cleared as the hardware
+ * would, host registers are plain memory)
+ */
+void start()
+{
+    InputCapture::start(timer::ClockDiv8, InputCapture::EdgeBoth);
+    TIFR1 = 0;
+}
+
+/**
+ * InputCapture pulse measurement
+ * in EdgeBoth mode
+ */
+int main()
+{
+    host::reset();
+    start();
+
+    //Rising 100, falling 300, rising 1100
+    capture(100);
+    capture(300);
+    capture(1100);
+    capture(1300);
+    capture(2100);
+    CHECK(InputCapture::available() == 5);
+    uint32_t period = 0;
+    uint32_t high = 0;
+    CHECK(InputCapture::readPulse(period, high) == True);
+    CHECK(period == 1000);
+    CHECK(high == 200);
+    CHECK(InputCapture::available() == 3);
+    CHECK(InputCapture::readPulse(period, high) == True);
+    CHECK(period == 1000);
+    CHECK(high == 200);
+    CHECK(InputCapture::available() == 1);
+    CHECK(!InputCapture::readPulse(period, high));
+
+    //A lost capture (two rising edges in a row)
+    //is skipped and the sequence resynchronized
+    start();
+    capture(100);
+    TCCR1B |= 0b01000000;
+    capture(900);
+    capture(1250);
+    capture(1900);
+    CHECK(InputCapture::readPulse(period, high) == True);
+    CHECK(period == 1000);
+    CHECK(high == 350);
+    CHECK(InputCapture::dutyCycle(high, period) == 3500);
+
+    return test::end("inputCapture");
+}
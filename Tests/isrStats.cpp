@@ -0,0 +1,25 @@
+#define AVRPP11_ISR_STATS
+#include "test.h"
+
+/**
+ * Interrupt load computed in 32 bits
+ * (scaled down totals lose at most 1/10000)
+ */
+int main()
+{
+    host::reset();
+    isr::resetStats();
+    CHECK(isr::getLoad(isr::VectorSpi, 0) == 0);
+
+    isr::vectorStats[isr::VectorSpi].total = 1600000;
+    CHECK(isr::getLoad(isr::VectorSpi, 16000000) == 1000);
+
+    isr::vectorStats[isr::VectorSpi].total = 1000000000;
+    word load = isr::getLoad(isr::VectorSpi, 4000000000UL);
+    CHECK(load >= 2499 && load <= 2500);
+
+    isr::vectorStats[isr::VectorSpi].total = 4000000000UL;
+    CHECK(isr::getLoad(isr::VectorSpi, 4000000000UL) == 10000);
+
+    return test::end("isrStats");
+}
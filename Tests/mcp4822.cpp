@@ -0,0 +1,65 @@
+#include <vector>
+
+#include "test.h"
+#include "../AVRpp11/lib/MCP4822.hpp"
+
+/**
+ * Bytes sent by the Spi model
+ * and slave select state of each
+ */
+std::vector<byte> sent;
+std::vector<byte> selects;
+
+/**
+ * Spi model completing one transfer per
+ * step while the interrupt is enabled
+ */
+void spiModel()
+{
+    if (SPCR & 0b10000000) {
+        sent.push_back((byte)SPDR);
+        selects.push_back((byte)gpio::SS.readOutput());
+        host::raise(SPI_STC_vect);
+    }
+}
+
+/**
+ * MCP4822 interrupt transfer state machine
+ */
+int main()
+{
+    host::reset();
+    host::addModel(spiModel);
+    sei();
+    MCP4822::init(gpio::D7);
+
+    //Both channels: two 16 bits frames
+    //(channel bit, gain 2x, active, value)
+    MCP4822::writeBoth(0x123, 0xABC);
+    host::step(8);
+    CHECK(sent.size() == 4);
+    CHECK(sent == std::vector<byte>({0x11, 0x23, 0x9A, 0xBC}));
+    CHECK(selects == std::vector<byte>({Low, Low, Low, Low}));
+    CHECK(gpio::SS.readOutput() == High);
+    CHECK((SPCR & 0b10000000) == 0);
+
+    //One channel: one frame
+    sent.clear();
+    selects.clear();
+    MCP4822::writeChannel(MCP4822::ChannelB, 0xFFF);
+    host::step(8);
+    CHECK(sent == std::vector<byte>({0x9F, 0xFF}));
+    CHECK(gpio::SS.readOutput() == High);
+
+    //Polled: the transfer flag is always set on host
+    sent.clear();
+    SPSR |= 0b10000000;
+    MCP4822::writeChannel(MCP4822::ChannelA, 0x456,
+        MCP4822::TransferPolled);
+    host::step(8);
+    CHECK(sent.empty());
+    CHECK(SPDR == 0x56);
+    CHECK(gpio::D7.readOutput() == High);
+
+    return test::end("mcp4822");
+}
@@ -0,0 +1,67 @@
+#include "test.h"
+#include "../AVRpp11/lib/MemoryMonitor.hpp"
+
+/**
+ * Fault hook calls and last free size
+ */
+int faultCount = 0;
+word faultFree = 0;
+
+void fault(word freeSize)
+{
+    faultCount++;
+    faultFree = freeSize;
+}
+
+/**
+ * Paint the emulated SRAM free memory
+ * as the .init1 section would
+ */
+void paint()
+{
+    for (word i=0x100;i<=RAMEND;i++) {
+        host::sram[i] = MemoryMonitor::canary;
+    }
+}
+
+/**
+ * MemoryMonitor stack and heap tracking
+ * on the emulated SRAM (heap starts at 0x100)
+ */
+int main()
+{
+    host::reset();
+    paint();
+    MemoryMonitor::onFault(fault);
+
+    //Stack 0x100 bytes deep, nothing allocated
+    SP = RAMEND - 0x100;
+    host::sram[RAMEND - 0x100 + 1] = 0x00;
+    CHECK(MemoryMonitor::check() == True);
+    CHECK(faultCount == 0);
+    MemoryMonitor::Usage usage = MemoryMonitor::getUsage();
+    CHECK(usage.heapSize == 0);
+    CHECK(usage.stackMaxSize == 0x100);
+    CHECK(usage.freeSize == RAMEND - 0x100 - 0x100);
+
+    //Heap allocated then released by free(): the
+    //old heap data is painted again (no false fault)
+    host::__brkval = &host::sram[0x400];
+    for (word i=0x100;i<0x400;i++) {
+        host::sram[i] = 0x55;
+    }
+    CHECK(MemoryMonitor::check() == True);
+    host::__brkval = &host::sram[0x180];
+    CHECK(MemoryMonitor::check() == True);
+    CHECK(faultCount == 0);
+    CHECK(host::sram[0x180] == MemoryMonitor::canary);
+    CHECK(MemoryMonitor::getUsage().stackMaxSize == 0x100);
+
+    //Stack reaching the guard zone above the heap
+    host::sram[0x180 + 8] = 0x00;
+    CHECK(!MemoryMonitor::check());
+    CHECK(faultCount == 1);
+    CHECK(faultFree == SP - 0x180);
+
+    return test::end("memoryMonitor");
+}
@@ -0,0 +1,94 @@
+#include <string>
+
+#include "test.h"
+#include "../AVRpp11/lib/Printer.hpp"
+
+/**
+ * Characters sent by the Usart model
+ */
+std::string output;
+
+/**
+ * Usart model sending one byte per step
+ * while the write ready interrupt is enabled
+ */
+void usartModel()
+{
+    if (UCSR0B & 0b00100000) {
+        host::raise(USART_UDRE_vect);
+        output += (char)UDR0;
+    }
+}
+
+/**
+ * Return the characters
+ * printed since last call
+ */
+std::string flush()
+{
+    host::step(2*Printer::bufferSize);
+    std::string text = output;
+    output.clear();
+    return text;
+}
+
+/**
+ * Printer formatting
+ */
+int main()
+{
+    host::reset();
+    host::addModel(usartModel);
+    Printer::init(usart::BaudRate9600);
+
+    Printer::write('a');
+    Printer::write("bc");
+    CHECK(flush() == "abc");
+
+    Printer::write((byte)0);
+    Printer::write(' ');
+    Printer::write((byte)7);
+    Printer::write(' ');
+    Printer::write((byte)100);
+    Printer::write(' ');
+    Printer::write((byte)255);
+    CHECK(flush() == "0 7 100 255");
+
+    Printer::write((word)0);
+    Printer::write(' ');
+    Printer::write((word)10);
+    Printer::write(' ');
+    Printer::write((word)1005);
+    Printer::write(' ');
+    Printer::write((word)65535);
+    CHECK(flush() == "0 10 1005 65535");
+
+    Printer::write((uint32_t)0);
+    Printer::write(' ');
+    Printer::write((uint32_t)1000000UL);
+    Printer::write(' ');
+    Printer::write((uint32_t)4294967295UL);
+    CHECK(flush() == "0 1000000 4294967295");
+
+    Printer::write((sbyte)-128);
+    Printer::write(' ');
+    Printer::write((sword)-32768);
+    Printer::write(' ');
+    Printer::write(-23456);
+    Printer::write(' ');
+    Printer::write(404);
+    CHECK(flush() == "-128 -32768 -23456 404");
+
+    Printer::write(True);
+    Printer::write(False);
+    Printer::endl();
+    CHECK(flush() == "TrueFalse\r\n");
+
+    //Longer than the ring buffer
+    for (byte i=0;i<3;i++) {
+        Printer::write("0123456789");
+    }
+    CHECK(flush() == "012345678901234567890123456789");
+
+    return test::end("printer");
+}
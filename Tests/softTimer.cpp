@@ -0,0 +1,55 @@
+#include "test.h"
+#include "../AVRpp11/lib/SoftTimer.hpp"
+
+/**
+ * Number of callback calls
+ */
+int callCount = 0;
+
+void callback()
+{
+    callCount++;
+}
+
+/**
+ * SoftTimer programming and expiry
+ * (Timer1 counter is set by hand)
+ */
+int main()
+{
+    host::reset();
+    SystemClock::init();
+    sei();
+
+    //Periods below the minimum are rejected
+    CHECK(SoftTimer::start(callback, 1000, 10) == SoftTimer::None);
+
+    //Programming the compare only writes one to its
+    //flag: a pending overflow is kept for SystemClock
+    //(counter past half the wrap, not counted yet)
+    TCNT1 = 0x9000;
+    TIFR1 = 0b00000001;
+    byte id = SoftTimer::start(callback, 1000, 1000);
+    CHECK(id == 0);
+    CHECK(TIFR1 == 0b00000010);
+    CHECK(OCR1A == 0x9000 + 1000);
+    TIFR1 = 0;
+
+    //Handler far behind a short period calls the
+    //callback once and rearms after current time
+    TCNT1 = 0x9000 + 10500;
+    host::raise(TIMER1_COMPA_vect);
+    CHECK(callCount == 1);
+    CHECK(OCR1A == 0x9000 + 11000);
+    TCNT1 = 0x9000 + 11000;
+    host::raise(TIMER1_COMPA_vect);
+    CHECK(callCount == 2);
+    CHECK(OCR1A == 0x9000 + 12000);
+
+    //Stopped timer disables the compare interrupt
+    SoftTimer::stop(id);
+    CHECK(SoftTimer::isActive(id) != True);
+    CHECK((TIMSK1 & 0b00000010) == 0);
+
+    return test::end("softTimer");
+}
@@ -0,0 +1,57 @@
+#ifndef TEST_H
+#define TEST_H
+
+/**
+ * Host unit test harness
+ *
+ * Tests are built natively with the AVRpp11/host
+ * backend and run by make test. Each test file is a
+ * program checking conditions with CHECK() and
+ * returning test::end() from main.
+ */
+#include <stdio.h>
+
+#include "../AVRpp11/mapping/arduino.h"
+#include "../AVRpp11/avrpp11.h"
+
+namespace test {
+
+/**
+ * Number of checks and failures
+ */
+int checkCount = 0;
+int failureCount = 0;
+
+/**
+ * Record given check result
+ */
+inline void check(bool isOk, const char* expression,
+    const char* file, int line)
+{
+    checkCount++;
+    if (!isOk) {
+        failureCount++;
+        printf("%s:%d: check failed: %s\n", file, line, expression);
+    }
+}
+
+/**
+ * Print the summary and return
+ * the process exit status
+ */
+inline int end(const char* name)
+{
+    printf("%s: %d checks, %d failures\n",
+        name, checkCount, failureCount);
+    return failureCount == 0 ? 0 : 1;
+}
+
+}
+
+/**
+ * Check given condition
+ */
+#define CHECK(condition) \
+    test::check((condition), #condition, __FILE__, __LINE__)
+
+#endif
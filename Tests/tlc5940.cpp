@@ -0,0 +1,53 @@
+#include "test.h"
+#include "../AVRpp11/lib/TLC5940.hpp"
+
+typedef TLC5940<2> Leds;
+
+/**
+ * Return true if XLAT (OC1A) is
+ * connected to Timer1
+ */
+bool isLatchConnected()
+{
+    return (TCCR1A & 0b11000000) != 0;
+}
+
+/**
+ * TLC5940 polled upload and XLAT
+ * connection around Timer1 BOTTOM
+ * (polled transfer flag is always set on host)
+ */
+int main()
+{
+    host::reset();
+    sei();
+    Leds::init();
+    SPSR |= 0b10000000;
+
+    //Upload far from BOTTOM: XLAT connected
+    //for the pulse ending the current period
+    Leds::set(0, 4095);
+    TCNT1 = 1000;
+    CHECK(Leds::update() == True);
+    CHECK(SPDR == 0xFF);
+    CHECK(isLatchConnected());
+    CHECK(Leds::isUpdatePending() == True);
+    CHECK(Leds::update() != True);
+    host::raise(TIMER1_OVF_vect);
+    CHECK(!isLatchConnected());
+    CHECK(!Leds::isUpdatePending());
+
+    //Upload next to BOTTOM: the XLAT pulse may
+    //be over, connected at BOTTOM for next period
+    TCNT1 = 10;
+    CHECK(Leds::update() == True);
+    CHECK(!isLatchConnected());
+    host::raise(TIMER1_OVF_vect);
+    CHECK(isLatchConnected());
+    CHECK(Leds::isUpdatePending() == True);
+    host::raise(TIMER1_OVF_vect);
+    CHECK(!isLatchConnected());
+    CHECK(!Leds::isUpdatePending());
+
+    return test::end("tlc5940");
+}
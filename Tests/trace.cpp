@@ -0,0 +1,44 @@
+#include "test.h"
+#include "../AVRpp11/lib/Trace.hpp"
+
+/**
+ * Trace recording, trigger and freeze
+ */
+int main()
+{
+    host::reset();
+    SystemClock::init();
+    sei();
+    Trace::clear();
+
+    //Trigger on event 5 followed by 4 records
+    Trace::setTrigger(5, 4);
+    for (byte i=0;i<10;i++) {
+        TRACE(i, i*100);
+    }
+    CHECK(Trace::isFrozen() == True);
+    CHECK(Trace::getTriggerIndex() == 63 - 4);
+    CHECK(Trace::read(63).id == 9);
+    CHECK(Trace::read(63).arg == 900);
+    CHECK(Trace::read(0).id == Trace::None);
+
+    //Records after the trigger freeze are dropped
+    for (byte i=10;i<50;i++) {
+        TRACE(i, i);
+    }
+    CHECK(Trace::read(63).id == 9);
+    CHECK(Trace::read(59).id == 5);
+
+    //Manual freeze and resume
+    Trace::clear();
+    TRACE(1, 1);
+    Trace::freeze();
+    TRACE(2, 2);
+    CHECK(Trace::read(63).id == 1);
+    Trace::resume();
+    TRACE(3, 3);
+    CHECK(Trace::read(63).id == 3);
+    CHECK(Trace::read(62).id == 1);
+
+    return test::end("trace");
+}
@@ -0,0 +1,69 @@
+#!/bin/sh
+###
+### Build the micro benchmark firmwares of Bench/
+### and run them headless under simavr
+###
+### usage: Tools/bench.sh [baseline]
+### Prints a "firmware benchmark cycles" table, saved
+### in $BUILD_DIRECTORY/bench.txt. When a previous table
+### is given, the difference with it is added.
+###
+
+CXX=${CXX:-avr-g++}
+SIMAVR=${SIMAVR:-simavr}
+SIMAVR_INCLUDE=${SIMAVR_INCLUDE:-/usr/include}
+MCU=${MCU:-atmega328p}
+F_CPU=${F_CPU:-16000000UL}
+FLAGS=${FLAGS:--Os -std=c++11}
+BUILD_DIRECTORY=${BUILD_DIRECTORY:-build}
+TIMEOUT=${TIMEOUT:-20}
+
+BASELINE=$1
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+OUTPUT=$BUILD_DIRECTORY/bench
+RESULT=$BUILD_DIRECTORY/bench.txt
+
+mkdir -p "$OUTPUT" || exit 1
+: > "$RESULT.tmp"
+
+STATUS=0
+for SOURCE in "$ROOT"/Bench/*.cpp; do
+    NAME=$(basename "$SOURCE" .cpp)
+    ELF=$OUTPUT/$NAME.elf
+    #Keep the simavr description section out of flash
+    if ! $CXX $FLAGS -DF_CPU=$F_CPU -mmcu=$MCU -I"$SIMAVR_INCLUDE" \
+        -Wl,--undefined=_mmcu,--section-start=.mmcu=0x910000 \
+        -o "$ELF" "$SOURCE"
+    then
+        echo "bench: $NAME build failed" >&2
+        STATUS=1
+        continue
+    fi
+    #Console lines may be prefixed or colored by simavr
+    timeout "$TIMEOUT" $SIMAVR "$ELF" 2>&1 |
+        sed -n 's/^.*BENCH \([^ ]*\) \([0-9]*\).*$/\1 \2/p' |
+        while read -r BENCH CYCLES; do
+            echo "$NAME $BENCH $CYCLES"
+        done >> "$RESULT.tmp"
+    if ! grep -q "^$NAME " "$RESULT.tmp"; then
+        echo "bench: $NAME produced no result" >&2
+        STATUS=1
+    fi
+done
+mv "$RESULT.tmp" "$RESULT"
+
+if [ -n "$BASELINE" ] && [ -f "$BASELINE" ]; then
+    awk 'NR == FNR { base[$1 " " $2] = $3; next }
+        {
+            key = $1 " " $2
+            if (key in base) {
+                printf "%-12s %-36s %8d %+8d\n", $1, $2, $3, $3 - base[key]
+            } else {
+                printf "%-12s %-36s %8d %8s\n", $1, $2, $3, "new"
+            }
+        }' "$BASELINE" "$RESULT"
+else
+    awk '{ printf "%-12s %-36s %8d\n", $1, $2, $3 }' "$RESULT"
+fi
+
+exit $STATUS
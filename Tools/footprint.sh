@@ -0,0 +1,154 @@
+#!/bin/sh
+###
+### Build the footprint firmwares of Footprint/ and
+### report their flash and RAM sizes, the difference
+### with the empty firmware and the symbols each
+### feature adds. Fails when a budget is exceeded
+### or a feature has no budget line.
+###
+### usage: Tools/footprint.sh [-u]
+### -u : write the measured sizes as new budgets with
+### a headroom of 10% of the feature footprint (at least
+### 32 bytes of flash and 8 bytes of RAM)
+###
+### Budget file lines are "feature flash ram" in bytes.
+### Tables are saved in $BUILD_DIRECTORY/footprint/.
+###
+
+CXX=${CXX:-avr-g++}
+SIZE=${SIZE:-avr-size}
+NM=${NM:-avr-nm}
+MCU=${MCU:-atmega328p}
+F_CPU=${F_CPU:-16000000UL}
+FLAGS=${FLAGS:--Os -std=c++11}
+BUILD_DIRECTORY=${BUILD_DIRECTORY:-build}
+
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+BUDGET=${BUDGET:-$ROOT/Footprint/budget.txt}
+OUTPUT=$BUILD_DIRECTORY/footprint
+SIZES=$OUTPUT/sizes.txt
+SYMBOLS=$OUTPUT/symbols.txt
+
+mkdir -p "$OUTPUT" || exit 1
+: > "$SIZES"
+: > "$SYMBOLS"
+
+STATUS=0
+for SOURCE in "$ROOT"/Footprint/*.cpp; do
+    NAME=$(basename "$SOURCE" .cpp)
+    ELF=$OUTPUT/$NAME.elf
+    if ! $CXX $FLAGS -DF_CPU=$F_CPU -mmcu=$MCU -o "$ELF" "$SOURCE"; then
+        echo "footprint: $NAME build failed" >&2
+        STATUS=1
+        continue
+    fi
+    #Flash is .text and .data, RAM is .data and .bss
+    $SIZE -A "$ELF" | awk -v name="$NAME" '
+        $1 == ".text" { text = $2 }
+        $1 == ".data" { data = $2 }
+        $1 == ".bss" { bss = $2 }
+        END { print name, text + data, data + bss }' >> "$SIZES"
+    #Symbols with decimal sizes: "feature type size name"
+    $NM -S -C --size-sort -t d "$ELF" | awk -v name="$NAME" '
+        NF >= 4 {
+            symbol = $4
+            for (i=5;i<=NF;i++) {
+                symbol = symbol " " $i
+            }
+            print name, $3, $2 + 0, symbol
+        }' >> "$SYMBOLS"
+done
+
+if [ "$1" = "-u" ]; then
+    {
+        grep -E '^#' "$BUDGET" 2>/dev/null
+        awk '
+            function headroom(size, base, minimum,    margin) {
+                margin = int((size - base + 9)/10)
+                return margin < minimum ? minimum : margin
+            }
+            $1 == "empty" { baseFlash = $2; baseRam = $3 }
+            { name[NR] = $1; flash[NR] = $2; ram[NR] = $3 }
+            END {
+                for (i=1;i<=NR;i++) {
+                    print name[i], \
+                        flash[i] + headroom(flash[i], baseFlash, 32), \
+                        ram[i] + headroom(ram[i], baseRam, 8)
+                }
+            }' "$SIZES"
+    } > "$BUDGET.tmp" && mv "$BUDGET.tmp" "$BUDGET"
+    echo "footprint: budgets written to $BUDGET"
+fi
+
+#Per feature table with budget check
+awk -v budgetFile="$BUDGET" '
+    BEGIN {
+        while ((getline line < budgetFile) > 0) {
+            if (line ~ /^#/ || split(line, field, " ") < 3) {
+                continue
+            }
+            budgetFlash[field[1]] = field[2]
+            budgetRam[field[1]] = field[3]
+        }
+    }
+    $1 == "empty" { baseFlash = $2; baseRam = $3 }
+    { name[NR] = $1; flash[NR] = $2; ram[NR] = $3 }
+    END {
+        printf "%-16s %7s %6s %7s %6s  %s\n", \
+            "feature", "flash", "ram", "+flash", "+ram", "budget"
+        status = 0
+        for (i=1;i<=NR;i++) {
+            key = name[i]
+            if (!(key in budgetFlash)) {
+                verdict = "NO BUDGET"
+                status = 1
+                isMissing = 1
+            } else if (flash[i] > budgetFlash[key] || ram[i] > budgetRam[key]) {
+                verdict = "OVER " budgetFlash[key] " " budgetRam[key]
+                status = 1
+            } else {
+                verdict = "ok"
+            }
+            printf "%-16s %7d %6d %+7d %+6d  %s\n", name[i], flash[i], \
+                ram[i], flash[i] - baseFlash, ram[i] - baseRam, verdict
+        }
+        if (isMissing) {
+            print "footprint: missing budgets, measure them" \
+                " with make footprint-update" > "/dev/stderr"
+        }
+        exit status
+    }' "$SIZES" || STATUS=1
+
+#Largest symbols added by each feature
+awk '
+    function symbol(    text, i) {
+        text = $4
+        for (i=5;i<=NF;i++) {
+            text = text " " $i
+        }
+        return text
+    }
+    NR == FNR {
+        if ($1 == "empty") {
+            base[symbol()] = 1
+        }
+        next
+    }
+    $1 != "empty" && !(symbol() in base) {
+        print $1, $3, $2, symbol()
+    }' "$SYMBOLS" "$SYMBOLS" | sort -k1,1 -k2,2nr | awk '
+    $1 != feature {
+        feature = $1
+        count = 0
+        printf "\n%s:\n", feature
+    }
+    count < 8 {
+        text = $4
+        for (i=5;i<=NF;i++) {
+            text = text " " $i
+        }
+        printf "  %6d %s %s\n", $2, $3, text
+        count++
+    }'
+
+exit $STATUS
@@ -0,0 +1,198 @@
+/**
+ * Host side viewer of AVRpp11 Trace dumps
+ *
+ * Reads the binary stream sent by Trace::dump()
+ * (captured from the serial port into a file) and
+ * prints the records as a timeline: time relative to
+ * the trigger (or the first record) and to the previous
+ * record in microseconds, one lane per event id, event
+ * name and argument. Event names are optionally read
+ * from a text file with one "id name" pair per line.
+ *
+ * stty -F /dev/ttyUSB0 raw 9600
+ * cat /dev/ttyUSB0 > trace.bin
+ * traceView trace.bin names.txt
+ */
+#include <cstdio>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * Empty record id and
+ * dump sizes in bytes
+ */
+static const int None = 0xFF;
+static const int headerSize = 3;
+static const int recordSize = 6;
+
+/**
+ * Decoded record with
+ * unwrapped timestamp in cycles
+ */
+struct Record {
+    uint64_t time;
+    int id;
+    unsigned int arg;
+    bool isTrigger;
+};
+
+/**
+ * Read the whole given file or
+ * standard input if path is "-"
+ */
+static bool readDump(const std::string& path, std::vector<uint8_t>& data)
+{
+    std::istream* input = &std::cin;
+    std::ifstream file;
+    if (path != "-") {
+        file.open(path.c_str(), std::ios::binary);
+        if (!file) {
+            return false;
+        }
+        input = &file;
+    }
+    char c;
+    while (input->get(c)) {
+        data.push_back((uint8_t)c);
+    }
+    return true;
+}
+
+/**
+ * Read "id name" lines of given file
+ */
+static void readNames(const std::string& path, std::map<int, std::string>& names)
+{
+    std::ifstream file(path.c_str());
+    int id;
+    std::string name;
+    while (file >> id >> name) {
+        names[id] = name;
+    }
+}
+
+/**
+ * Decode the records from the oldest and unwrap the
+ * 24 bits timestamps. The overflow byte is late by one
+ * when the Timer1 overflow was pending at record time,
+ * so a timestamp going backward by about 65536 cycles
+ * is moved forward by one overflow.
+ */
+static std::vector<Record> decode(const std::vector<uint8_t>& data,
+    int count, int triggerIndex)
+{
+    std::vector<Record> records;
+    uint64_t time = 0;
+    uint32_t previous = 0;
+    bool isFirst = true;
+    for (int i=0;i<count;i++) {
+        const uint8_t* bytes = &data[headerSize + i*recordSize];
+        int id = bytes[3];
+        if (id == None) {
+            continue;
+        }
+        uint32_t stamp = bytes[0] | (bytes[1] << 8) | (bytes[2] << 16);
+        if (isFirst) {
+            time = stamp;
+            isFirst = false;
+        } else {
+            uint32_t delta = (stamp - previous) & 0xFFFFFF;
+            if (delta >= 0xFF0000) {
+                stamp = (stamp + 0x10000) & 0xFFFFFF;
+                delta = (stamp - previous) & 0xFFFFFF;
+            }
+            time += delta;
+        }
+        previous = stamp;
+        Record record;
+        record.time = time;
+        record.id = id;
+        record.arg = bytes[4] | (bytes[5] << 8);
+        record.isTrigger = (i == triggerIndex);
+        records.push_back(record);
+    }
+    return records;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2 || argc > 3) {
+        std::cerr << "usage: traceView dump.bin|- [names.txt]" << std::endl;
+        return 1;
+    }
+    std::vector<uint8_t> data;
+    if (!readDump(argv[1], data)) {
+        std::cerr << "traceView: cannot read " << argv[1] << std::endl;
+        return 1;
+    }
+    std::map<int, std::string> names;
+    if (argc == 3) {
+        readNames(argv[2], names);
+    }
+    if (data.size() < (size_t)headerSize) {
+        std::cerr << "traceView: truncated header" << std::endl;
+        return 1;
+    }
+    int count = data[0];
+    int triggerIndex = data[1];
+    int cyclesPerMicro = data[2];
+    if (cyclesPerMicro == 0 ||
+        data.size() < (size_t)(headerSize + count*recordSize)
+    ) {
+        std::cerr << "traceView: invalid or truncated dump" << std::endl;
+        return 1;
+    }
+
+    std::vector<Record> records = decode(data, count, triggerIndex);
+    if (records.empty()) {
+        std::cout << "empty trace" << std::endl;
+        return 0;
+    }
+
+    //Time origin and lanes
+    uint64_t origin = records[0].time;
+    std::map<int, size_t> lanes;
+    for (size_t i=0;i<records.size();i++) {
+        if (records[i].isTrigger) {
+            origin = records[i].time;
+        }
+        lanes[records[i].id] = 0;
+    }
+    size_t lane = 0;
+    for (std::map<int, size_t>::iterator it=lanes.begin();it!=lanes.end();it++) {
+        it->second = lane++;
+    }
+
+    std::printf("%d records, %d cycles/us%s\n",
+        (int)records.size(), cyclesPerMicro,
+        triggerIndex == None ? ", not triggered" : "");
+    std::printf("%12s %10s  ", "time(us)", "delta(us)");
+    for (std::map<int, size_t>::iterator it=lanes.begin();it!=lanes.end();it++) {
+        std::printf("%d", it->first % 10);
+    }
+    std::printf("  event arg\n");
+
+    uint64_t previous = records[0].time;
+    for (size_t i=0;i<records.size();i++) {
+        const Record& record = records[i];
+        double time = ((double)record.time - (double)origin)/cyclesPerMicro;
+        double delta = (double)(record.time - previous)/cyclesPerMicro;
+        previous = record.time;
+        std::printf("%12.3f %10.3f  ", time, delta);
+        std::string lanesText(lanes.size(), '|');
+        lanesText[lanes[record.id]] = record.isTrigger ? 'T' : '*';
+        std::printf("%s  ", lanesText.c_str());
+        if (names.count(record.id)) {
+            std::printf("%s", names[record.id].c_str());
+        } else {
+            std::printf("%d", record.id);
+        }
+        std::printf(" %u (0x%04X)\n", record.arg, record.arg);
+    }
+
+    return 0;
+}
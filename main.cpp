@@ -1,4 +1,4 @@
-#include "AVRpp11/mapping/arduinoUno.h"
+#include "AVRpp11/mapping/arduino.h"
 //#include "AVRpp11/mapping/atmega328p.h"
 #include "AVRpp11/avrpp11.h"
 
@@ -84,11 +84,42 @@ int main()
     timer::Timer1.setCounterMode(timer::WaveNormalTopCompareA);
     timer::Timer1.setPinModeA(timer::PinDisable);
     timer::Timer1.setPinModeB(timer::PinDisable);
-    timer::Timer1.setClock(timer::ClockDiv1024);
-    timer::Timer1.writeCompareA(15625);
+    timer::Timer1.setPeriod(timer::TimerPeriod<
+        timer::cyclesFromFrequency(1), timer::Width16Bits,
+        timer::PrescalersTimer01, 100>::setting);
     timer::Timer1.onMatchA([](HandlerArg(timer::Timer1) t) {
         gpio::D13.toggle();
     });
+    timer::Timer1.setCaptureEdge(timer::CaptureRising);
+    timer::Timer1.setCaptureNoiseCanceler(True);
+    timer::Timer1.onCapture([](HandlerArg(timer::Timer1) t) {
+        volatile word w1 = t.readCapture();
+    });
+    isr::enable();
+
+    //Timer2 8 bits
+    isr::disable();
+    timer::Timer2.setCounterMode(timer::WaveNormalTopCompareA);
+    timer::Timer2.setPinModeA(timer::PinDisable);
+    timer::Timer2.setPinModeB(timer::PinDisable);
+    timer::Timer2.setClock(timer::ClockDiv128);
+    timer::Timer2.writeCompareA(124);
+    timer::Timer2.onMatchA([](HandlerArg(timer::Timer2) t) {
+        gpio::D13.toggle();
+    });
+    isr::enable();
+
+    //Analog comparator
+    isr::disable();
+    comparator::AnalogComparator.enable();
+    comparator::AnalogComparator.setPositiveInput(comparator::PositiveBandgap);
+    comparator::AnalogComparator.setNegativeInput(comparator::NegativePinAin1);
+    comparator::AnalogComparator.setEdge(comparator::EdgeRising);
+    volatile logic l8 = comparator::AnalogComparator.read();
+    comparator::AnalogComparator.onTrigger(
+        [](HandlerArg(comparator::AnalogComparator) c) {
+        gpio::D13.toggle();
+    });
     isr::enable();
 
     //Printer